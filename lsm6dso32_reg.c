@@ -19,6 +19,13 @@
 
 #include "lsm6dso32_reg.h"
 
+#if (DRV_BYTE_ORDER == DRV_LITTLE_ENDIAN) && defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif (DRV_BYTE_ORDER == DRV_LITTLE_ENDIAN) && defined(__aarch64__) && \
+      defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif /* SIMD FIFO unpack */
+
 /**
   * @defgroup  LSM6DSO32
   * @brief     This file provides a set of functions needed to drive the
@@ -1158,6 +1165,333 @@ int32_t lsm6dso32_timestamp_raw_get(const stmdev_ctx_t *ctx, uint32_t *val)
   return ret;
 }
 
+/**
+  * @brief  Actual accelerometer and gyroscope output data rate, trimmed
+  *         by INTERNAL_FREQ_FINE.[get]
+  *
+  *         ODR = 6667 Hz * (1 + 0.0015 * FREQ_FINE) / ODR_Coeff
+  *         with ODR_Coeff from 512 (12.5 Hz) to 1 (6667 Hz). The
+  *         accelerometer ODR_XL = 1011b is 1.6 Hz (ODR_Coeff 4096) in
+  *         low-power mode and 12.5 Hz in high-performance mode
+  *         (CTRL6_C.XL_HM_MODE). 0 Hz is returned for a sensor in
+  *         power-down.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  xl_hz    accelerometer actual ODR [Hz]
+  * @param  gy_hz    gyroscope actual ODR [Hz]
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_odr_actual_get(const stmdev_ctx_t *ctx,
+                                 float_t *xl_hz, float_t *gy_hz)
+{
+  lsm6dso32_reg_t ctrl[6];
+  float_t hz[2];
+  float_t base;
+  uint8_t freq_fine;
+  uint8_t odr;
+  uint8_t i;
+  int32_t ret;
+
+  ret = lsm6dso32_odr_cal_reg_get(ctx, &freq_fine);
+
+  if (ret == 0)
+  {
+    /* CTRL1_XL .. CTRL6_C */
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL1_XL, (uint8_t *)ctrl, 6);
+  }
+
+  if (ret == 0)
+  {
+    base = 6667.0f * (1.0f + (0.0015f * (float_t)(int8_t)freq_fine));
+
+    for (i = 0U; i < 2U; i++)
+    {
+      odr = (i == 0U) ? ctrl[0].ctrl1_xl.odr_xl : ctrl[1].ctrl2_g.odr_g;
+
+      if ((odr >= 1U) && (odr <= 10U))
+      {
+        hz[i] = base / (float_t)(1UL << (10U - odr));
+      }
+
+      else if ((odr == 0x0BU) && (i == 0U) &&
+               (ctrl[5].ctrl6_c.xl_hm_mode == PROPERTY_DISABLE))
+      {
+        /* accelerometer high-performance: 12.5 Hz */
+        hz[i] = base / 512.0f;
+      }
+
+      else if ((odr == 0x0BU) && (i == 0U))
+      {
+        /* accelerometer low-power: 1.6 Hz */
+        hz[i] = base / 4096.0f;
+      }
+
+      else
+      {
+        hz[i] = 0.0f;
+      }
+    }
+
+    *xl_hz = hz[0];
+    *gy_hz = hz[1];
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Actual timestamp resolution, trimmed by
+  *         INTERNAL_FREQ_FINE.[get]
+  *
+  *         LSB = 25 us / (1 + 0.0015 * FREQ_FINE)
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      timestamp LSB [us]
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_timestamp_lsb_get(const stmdev_ctx_t *ctx, float_t *val)
+{
+  uint8_t freq_fine;
+  int32_t ret;
+
+  ret = lsm6dso32_odr_cal_reg_get(ctx, &freq_fine);
+
+  if (ret == 0)
+  {
+    *val = 25.0f / (1.0f + (0.0015f * (float_t)(int8_t)freq_fine));
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Initialize the ODR / timestamp drift estimator.[set]
+  *
+  * @param  drift    drift estimator
+  * @param  lsb_us   initial timestamp LSB (lsm6dso32_timestamp_lsb_get)
+  * @param  odr_hz   initial ODR of the tracked sensor
+  *                  (lsm6dso32_odr_actual_get)
+  *
+  */
+void lsm6dso32_odr_drift_init(lsm6dso32_odr_drift_t *drift, float_t lsb_us,
+                              float_t odr_hz)
+{
+  drift->lsb_us = lsb_us;
+  drift->period_us = (odr_hz > 0.0f) ? (1000000.0f / odr_hz) : 0.0f;
+  drift->ts0 = 0U;
+  drift->host0 = 0U;
+  drift->samples = 0U;
+  drift->started = PROPERTY_DISABLE;
+  drift->windows = 0U;
+}
+
+/**
+  * @brief  Refine timestamp LSB and sample period from FIFO
+  *         timestamps.[set]
+  *
+  *         Over windows of LSM6DSO32_ODR_DRIFT_WINDOW_TICKS device ticks
+  *         the number of samples per tick gives the period in device
+  *         time and, when a host clock is provided, the host time per
+  *         tick refines the timestamp LSB. Windows are blended with a
+  *         1/4 weight after the first one.
+  *
+  * @param  drift    drift estimator
+  * @param  ts       device timestamp (e.g. last TIMESTAMP_TAG)
+  * @param  host_us  host time of the same event [us], 0 if not available
+  * @param  samples  samples of the tracked sensor since previous update
+  *
+  */
+void lsm6dso32_odr_drift_update(lsm6dso32_odr_drift_t *drift, uint32_t ts,
+                                uint32_t host_us, uint32_t samples)
+{
+  float_t lsb_us;
+  float_t period_us;
+  uint32_t ticks;
+
+  if (drift->started == PROPERTY_DISABLE)
+  {
+    drift->ts0 = ts;
+    drift->host0 = host_us;
+    drift->samples = 0U;
+    drift->started = PROPERTY_ENABLE;
+  }
+
+  else
+  {
+    drift->samples += samples;
+    ticks = ts - drift->ts0;
+
+    if ((ticks >= LSM6DSO32_ODR_DRIFT_WINDOW_TICKS) && (drift->samples > 0U))
+    {
+      lsb_us = drift->lsb_us;
+
+      if ((host_us != 0U) && (drift->host0 != 0U))
+      {
+        lsb_us = (float_t)(host_us - drift->host0) / (float_t)ticks;
+      }
+
+      period_us = lsb_us * (float_t)ticks / (float_t)drift->samples;
+
+      if (drift->windows == 0U)
+      {
+        drift->lsb_us = lsb_us;
+        drift->period_us = period_us;
+      }
+
+      else
+      {
+        drift->lsb_us += 0.25f * (lsb_us - drift->lsb_us);
+        drift->period_us += 0.25f * (period_us - drift->period_us);
+      }
+
+      drift->windows = (drift->windows < 0xFFU) ? (drift->windows + 1U) : 0xFFU;
+      drift->ts0 = ts;
+      drift->host0 = host_us;
+      drift->samples = 0U;
+    }
+  }
+}
+
+/**
+  * @brief  Reset the device to host time synchronization.[set]
+  *
+  * @param  sync     synchronization state (one per device)
+  *
+  */
+void lsm6dso32_sync_init(lsm6dso32_sync_t *sync)
+{
+  sync->num = 0U;
+  sync->idx = 0U;
+  sync->last_ts = 0U;
+  sync->last_dev = 0;
+  sync->offset_us = 0.0;
+  sync->skew_us = 0.025;
+}
+
+/**
+  * @brief  Add a device timestamp / host time pair and update offset
+  *         and skew.[set]
+  *
+  *         Least squares fit over the last LSM6DSO32_SYNC_PAIRS pairs;
+  *         device timestamps are unwrapped to 64 bit.
+  *
+  * @param  sync     synchronization state
+  * @param  ts       device timestamp
+  * @param  host_us  shared host time of the same instant [us]
+  *
+  */
+void lsm6dso32_sync_add(lsm6dso32_sync_t *sync, uint32_t ts,
+                        uint64_t host_us)
+{
+  double_t dev_mean = 0.0;
+  double_t host_mean = 0.0;
+  double_t sxx = 0.0;
+  double_t sxy = 0.0;
+  double_t dx;
+  uint8_t i;
+
+  if (sync->num == 0U)
+  {
+    sync->last_dev = (int64_t)ts;
+  }
+
+  else
+  {
+    sync->last_dev += (int64_t)(int32_t)(ts - sync->last_ts);
+  }
+
+  sync->last_ts = ts;
+  sync->dev[sync->idx] = sync->last_dev;
+  sync->host[sync->idx] = host_us;
+  sync->idx = (uint8_t)((sync->idx + 1U) % LSM6DSO32_SYNC_PAIRS);
+  sync->num = (sync->num < LSM6DSO32_SYNC_PAIRS) ? (sync->num + 1U) : sync->num;
+
+  /* centered on the newest pair to keep double precision */
+  for (i = 0U; i < sync->num; i++)
+  {
+    dev_mean += (double_t)(sync->dev[i] - sync->last_dev);
+    host_mean += (double_t)(int64_t)(sync->host[i] - host_us);
+  }
+
+  dev_mean /= (double_t)sync->num;
+  host_mean /= (double_t)sync->num;
+
+  for (i = 0U; i < sync->num; i++)
+  {
+    dx = (double_t)(sync->dev[i] - sync->last_dev) - dev_mean;
+    sxx += dx * dx;
+    sxy += dx * ((double_t)(int64_t)(sync->host[i] - host_us) - host_mean);
+  }
+
+  if (sxx > 0.0)
+  {
+    sync->skew_us = sxy / sxx;
+  }
+
+  /* host = offset + skew * (dev - last_dev), offset in absolute host us */
+  sync->offset_us = (double_t)host_us + host_mean -
+                    (sync->skew_us * dev_mean);
+}
+
+/**
+  * @brief  Sample the device timestamp against the host clock.[get]
+  *
+  *         host_us must be taken as close as possible to the timestamp
+  *         read (or at a shared interrupt edge latched by all devices).
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  sync     synchronization state
+  * @param  host_us  shared host time [us]
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_sync_sample(const stmdev_ctx_t *ctx, lsm6dso32_sync_t *sync,
+                              uint64_t host_us)
+{
+  uint32_t ts;
+  int32_t ret;
+
+  ret = lsm6dso32_timestamp_raw_get(ctx, &ts);
+
+  if (ret == 0)
+  {
+    lsm6dso32_sync_add(sync, ts, host_us);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Map a device timestamp (e.g. from FIFO) in the common host
+  *         timebase.[get]
+  *
+  * @param  sync     synchronization state
+  * @param  ts       device timestamp, within +/- 14.9 h of the last pair
+  * @param  host_us  host time [us]
+  * @retval             0 -> mapped, -1 -> less than two pairs collected
+  *
+  */
+int32_t lsm6dso32_sync_to_host(const lsm6dso32_sync_t *sync, uint32_t ts,
+                               double_t *host_us)
+{
+  int32_t ret = 0;
+
+  if (sync->num < 2U)
+  {
+    ret = -1;
+  }
+
+  else
+  {
+    *host_us = sync->offset_us +
+               (sync->skew_us * (double_t)(int32_t)(ts - sync->last_ts));
+  }
+
+  return ret;
+}
+
 /**
   * @}
   *
@@ -1637,130 +1971,389 @@ int32_t lsm6dso32_ln_pg_read_byte(const stmdev_ctx_t *ctx, uint16_t address, uin
   return lsm6dso32_ln_pg_read(ctx, address, val, 1);
 }
 
+/**
+  * @brief  Read buffer in a page.[get]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  uint8_t address: page line address
+  * @param  uint8_t *buf: buffer to read
+  * @param  uint8_t len: buffer len
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
 int32_t lsm6dso32_ln_pg_read(const stmdev_ctx_t *ctx, uint16_t address, uint8_t *buf,
                              uint8_t len)
+{
+  lsm6dso32_pg_span_t span;
+
+  span.address = address;
+  span.buf = buf;
+  span.len = len;
+
+  return lsm6dso32_ln_pg_read_spans(ctx, &span, 1);
+}
+
+/* open an advanced page read session: embedded bank, PAGE_RW read */
+static int32_t lsm6dso32_ln_pg_read_open(const stmdev_ctx_t *ctx)
 {
   lsm6dso32_page_rw_t page_rw;
+  int32_t ret;
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *)&page_rw, 1);
+  }
+
+  if (ret == 0)
+  {
+    page_rw.page_rw = 0x01; /* page_read enable*/
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *)&page_rw, 1);
+  }
+
+  return ret;
+}
+
+/*
+ * Read one span in an open session; page is the page currently
+ * selected (0xFF when unknown), PAGE_SEL is written only on change.
+ */
+static int32_t lsm6dso32_ln_pg_read_span(const stmdev_ctx_t *ctx,
+                                         uint16_t address, uint8_t *buf,
+                                         uint8_t len, uint8_t *page)
+{
   lsm6dso32_page_sel_t page_sel;
-  lsm6dso32_page_address_t  page_address;
+  lsm6dso32_page_address_t page_address;
   uint8_t msb;
   uint8_t lsb;
-  int32_t ret;
-  uint8_t i ;
+  uint8_t j;
+  int32_t ret = 0;
 
   msb = ((uint8_t)(address >> 8) & 0x0FU);
   lsb = (uint8_t)address & 0xFFU;
-
-  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
-  if (ret != 0) { return ret; }
-
-  /* set page write */
-  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *) &page_rw, 1);
-  page_rw.page_rw = 0x01; /* page_read enable*/
-  ret += lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *) &page_rw, 1);
-  if (ret != 0) { goto exit; }
-
-  /* select page */
-  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *) &page_sel, 1);
-  page_sel.page_sel = msb;
   page_sel.not_used_01 = 1;
-  ret += lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *) &page_sel, 1);
-  if (ret != 0) { goto exit; }
 
-  for (i = 0; ((i < len) && (ret == 0)); i++)
+  for (j = 0; ((j < len) && (ret == 0)); j++)
   {
-    /* set page addr */
-    page_address.page_addr = lsb;
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_ADDRESS,
-                            (uint8_t *)&page_address, 1);
-    if (ret != 0) { goto exit; }
+    /* select page */
+    if (msb != *page)
+    {
+      *page = msb;
+      page_sel.page_sel = msb;
+      ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *) &page_sel, 1);
+    }
 
-    ret += lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_VALUE, &buf[i], 1);
-    if (ret != 0) { goto exit; }
+    /* set page addr: read auto-increment is not guaranteed */
+    if (ret == 0)
+    {
+      page_address.page_addr = lsb;
+      ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_ADDRESS,
+                                (uint8_t *)&page_address, 1);
+    }
+
+    if (ret == 0)
+    {
+      ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_VALUE, &buf[j], 1);
+    }
 
     lsb++;
 
     /* Check if page wrap */
-    if (((lsb & 0xFFU) == 0x00U) && (ret == 0))
+    if ((lsb & 0xFFU) == 0x00U)
     {
       msb++;
-      ret += lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *)&page_sel, 1);
-      if (ret != 0) { goto exit; }
-
-      page_sel.page_sel = msb;
-      page_sel.not_used_01 = 1;
-      ret += lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *)&page_sel, 1);
-      if (ret != 0) { goto exit; }
     }
   }
 
-  page_sel.page_sel = 0;
-  page_sel.not_used_01 = 1;
-  ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *) &page_sel, 1);
-  if (ret != 0) { goto exit; }
+  return ret;
+}
 
-  /* unset page write */
-  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *) &page_rw, 1);
-  page_rw.page_rw = 0x00; /* page_write disable */
-  ret += lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *) &page_rw, 1);
+/*
+ * Close an advanced page read session opened with status ret: page 0
+ * and PAGE_RW read disable on success, user bank in any case.
+ */
+static int32_t lsm6dso32_ln_pg_read_close(const stmdev_ctx_t *ctx,
+                                          uint8_t page, int32_t ret)
+{
+  lsm6dso32_page_sel_t page_sel;
+  lsm6dso32_page_rw_t page_rw;
+
+  if ((ret == 0) && (page != 0U))
+  {
+    page_sel.not_used_01 = 1;
+    page_sel.page_sel = 0;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_SEL, (uint8_t *) &page_sel, 1);
+  }
+
+  if (ret == 0)
+  {
+    /* unset page read */
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *) &page_rw, 1);
+    page_rw.page_rw = 0x00; /* page_read disable */
+    ret += lsm6dso32_write_reg(ctx, LSM6DSO32_PAGE_RW, (uint8_t *) &page_rw, 1);
+  }
 
-exit:
   ret += lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
 
   return ret;
 }
 
 /**
-  * @brief  Data-ready pulsed / letched mode.[set]
+  * @brief  Read several spans of the advanced pages in one session.[get]
+  *
+  *         The embedded functions bank and PAGE_RW read mode are set
+  *         once for all spans and PAGE_SEL is written only when the
+  *         page changes. PAGE_ADDRESS is written before every PAGE_VALUE
+  *         read: the address auto-increment is documented for page
+  *         writes only.
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      change the values of dataready_pulsed in
-  *                  reg COUNTER_BDR_REG1
+  * @param  span     spans to read (address, destination, length)
+  * @param  num      number of spans
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
-int32_t lsm6dso32_data_ready_mode_set(const stmdev_ctx_t *ctx,
-                                      lsm6dso32_dataready_pulsed_t val)
+int32_t lsm6dso32_ln_pg_read_spans(const stmdev_ctx_t *ctx,
+                                   const lsm6dso32_pg_span_t *span,
+                                   uint8_t num)
 {
-  lsm6dso32_counter_bdr_reg1_t reg;
+  uint8_t page = 0xFFU;
+  uint8_t i;
   int32_t ret;
 
-  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_COUNTER_BDR_REG1,
-                           (uint8_t *)&reg, 1);
+  ret = lsm6dso32_ln_pg_read_open(ctx);
 
-  if (ret == 0)
+  for (i = 0; ((i < num) && (ret == 0)); i++)
   {
-    reg.dataready_pulsed = (uint8_t)val;
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_COUNTER_BDR_REG1,
-                              (uint8_t *)&reg, 1);
+    ret = lsm6dso32_ln_pg_read_span(ctx, span[i].address, span[i].buf,
+                                    span[i].len, &page);
   }
 
-  return ret;
+  return lsm6dso32_ln_pg_read_close(ctx, page, ret);
 }
 
+#define LSM6DSO32_EMB_SNAPSHOT_SPANS  7U
+
+/* embedded functions bank registers captured by the snapshot */
+static const struct
+{
+  uint8_t   reg;
+  uint8_t   len;
+} lsm6dso32_emb_snapshot_reg[] =
+{
+  { LSM6DSO32_EMB_FUNC_EN_A,      2U },
+  { LSM6DSO32_EMB_FUNC_INT1,      3U },
+  { LSM6DSO32_EMB_FUNC_INT2,      3U },
+  { LSM6DSO32_PAGE_RW,            1U },
+  { LSM6DSO32_EMB_FUNC_FIFO_CFG,  1U },
+  { LSM6DSO32_FSM_ENABLE_A,       2U },
+  { LSM6DSO32_EMB_FUNC_ODR_CFG_B, 1U },
+};
+
+/* advanced pages spans captured by the snapshot (reserved lines skipped) */
+static const struct
+{
+  uint16_t  address;
+  uint8_t   len;
+} lsm6dso32_emb_snapshot_page[] =
+{
+  { LSM6DSO32_MAG_SENSITIVITY_L,   2U },
+  { LSM6DSO32_MAG_OFFX_L,         18U },
+  { LSM6DSO32_MAG_CFG_A,           2U },
+  { LSM6DSO32_FSM_LC_TIMEOUT_L,    3U },
+  { LSM6DSO32_FSM_START_ADD_L,     2U },
+  { LSM6DSO32_PEDO_CMD_REG,        2U },
+  { LSM6DSO32_PEDO_SC_DELTAT_L,    2U },
+};
+
 /**
-  * @brief  Data-ready pulsed / letched mode.[get]
+  * @brief  Embedded functions configuration snapshot.[get]
+  *
+  *         Embedded functions bank registers and advanced pages are
+  *         read in one embedded functions bank session. The FSM
+  *         programs area is not captured: it must be reloaded by the
+  *         application before lsm6dso32_emb_snapshot_set.
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      Get the values of
-  *                                     dataready_pulsed in
-  *                                     reg COUNTER_BDR_REG1
+  * @param  val      embedded functions snapshot
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
-int32_t lsm6dso32_data_ready_mode_get(const stmdev_ctx_t *ctx,
-                                      lsm6dso32_dataready_pulsed_t *val)
+int32_t lsm6dso32_emb_snapshot_get(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_emb_snapshot_t *val)
 {
-  lsm6dso32_counter_bdr_reg1_t reg;
+  uint8_t page = 0xFFU;
+  uint8_t ofs = 0U;
+  uint8_t i;
   int32_t ret;
 
-  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_COUNTER_BDR_REG1,
-                           (uint8_t *)&reg, 1);
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
 
-  switch (reg.dataready_pulsed)
+  for (i = 0U; (ret == 0) && (i < LSM6DSO32_EMB_SNAPSHOT_SPANS); i++)
   {
-    case LSM6DSO32_DRDY_LATCHED:
-      *val = LSM6DSO32_DRDY_LATCHED;
+    ret = lsm6dso32_read_reg(ctx, lsm6dso32_emb_snapshot_reg[i].reg,
+                             &val->reg[ofs], lsm6dso32_emb_snapshot_reg[i].len);
+    ofs += lsm6dso32_emb_snapshot_reg[i].len;
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_ln_pg_read_open(ctx);
+  }
+
+  ofs = 0U;
+
+  /* spans read straight from the table, no span array on the stack */
+  for (i = 0U; (ret == 0) && (i < LSM6DSO32_EMB_SNAPSHOT_SPANS); i++)
+  {
+    ret = lsm6dso32_ln_pg_read_span(ctx,
+                                    lsm6dso32_emb_snapshot_page[i].address,
+                                    &val->page[ofs],
+                                    lsm6dso32_emb_snapshot_page[i].len,
+                                    &page);
+    ofs += lsm6dso32_emb_snapshot_page[i].len;
+  }
+
+  /* back to the user bank in any case */
+  return lsm6dso32_ln_pg_read_close(ctx, page, ret);
+}
+
+/**
+  * @brief  Embedded functions configuration restore.[set]
+  *
+  *         Embedded functions are disabled, pages and bank registers
+  *         are written back and EMB_FUNC_EN_A/B are restored last so
+  *         that every function starts with its complete configuration.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      embedded functions snapshot
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_emb_snapshot_set(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_emb_snapshot_t *val)
+{
+  lsm6dso32_reg_t page_rw;
+  uint8_t emb_func_en[2] = { 0x00U, 0x00U };
+  uint8_t buff[3];
+  uint8_t ofs = 0U;
+  uint8_t i;
+  uint8_t j;
+  int32_t ret;
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_EN_A, emb_func_en, 2);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  for (i = 0U; (ret == 0) && (i < LSM6DSO32_EMB_SNAPSHOT_SPANS); i++)
+  {
+    ret = lsm6dso32_ln_pg_write(ctx, lsm6dso32_emb_snapshot_page[i].address,
+                                &val->page[ofs],
+                                lsm6dso32_emb_snapshot_page[i].len);
+    ofs += lsm6dso32_emb_snapshot_page[i].len;
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+  }
+
+  /* skip EMB_FUNC_EN_A/B, restored last */
+  ofs = lsm6dso32_emb_snapshot_reg[0].len;
+
+  for (i = 1U; (ret == 0) && (i < LSM6DSO32_EMB_SNAPSHOT_SPANS); i++)
+  {
+    for (j = 0U; j < lsm6dso32_emb_snapshot_reg[i].len; j++)
+    {
+      buff[j] = val->reg[ofs + j];
+    }
+
+    if (lsm6dso32_emb_snapshot_reg[i].reg == LSM6DSO32_PAGE_RW)
+    {
+      /* keep only emb_func_lir, page access stays closed */
+      page_rw.byte = buff[0];
+      page_rw.page_rw.page_rw = 0x00U;
+      buff[0] = page_rw.byte;
+    }
+
+    ret = lsm6dso32_write_reg(ctx, lsm6dso32_emb_snapshot_reg[i].reg,
+                              buff, lsm6dso32_emb_snapshot_reg[i].len);
+    ofs += lsm6dso32_emb_snapshot_reg[i].len;
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_EN_A, &val->reg[0], 2);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Data-ready pulsed / letched mode.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      change the values of dataready_pulsed in
+  *                  reg COUNTER_BDR_REG1
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_data_ready_mode_set(const stmdev_ctx_t *ctx,
+                                      lsm6dso32_dataready_pulsed_t val)
+{
+  lsm6dso32_counter_bdr_reg1_t reg;
+  int32_t ret;
+
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_COUNTER_BDR_REG1,
+                           (uint8_t *)&reg, 1);
+
+  if (ret == 0)
+  {
+    reg.dataready_pulsed = (uint8_t)val;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_COUNTER_BDR_REG1,
+                              (uint8_t *)&reg, 1);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Data-ready pulsed / letched mode.[get]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      Get the values of
+  *                                     dataready_pulsed in
+  *                                     reg COUNTER_BDR_REG1
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_data_ready_mode_get(const stmdev_ctx_t *ctx,
+                                      lsm6dso32_dataready_pulsed_t *val)
+{
+  lsm6dso32_counter_bdr_reg1_t reg;
+  int32_t ret;
+
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_COUNTER_BDR_REG1,
+                           (uint8_t *)&reg, 1);
+
+  switch (reg.dataready_pulsed)
+  {
+    case LSM6DSO32_DRDY_LATCHED:
+      *val = LSM6DSO32_DRDY_LATCHED;
       break;
 
     case LSM6DSO32_DRDY_PULSED:
@@ -1924,6 +2517,315 @@ int32_t lsm6dso32_boot_get(const stmdev_ctx_t *ctx, uint8_t *val)
   return ret;
 }
 
+/**
+  * @brief  Save the user bank configuration.[get]
+  *
+  *         All writable user bank registers are read in six bursts
+  *         (register auto-increment must be enabled).
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      user bank configuration
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_state_save(const stmdev_ctx_t *ctx,
+                             lsm6dso32_state_t *val)
+{
+  int32_t ret;
+
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_PIN_CTRL,
+                           (uint8_t *)&val->pin_ctrl, 1);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FIFO_CTRL1,
+                             (uint8_t *)&val->fifo_ctrl1, 8);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL1_XL,
+                             (uint8_t *)&val->ctrl1_xl, 10);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG0,
+                             (uint8_t *)&val->tap_cfg0, 10);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_I3C_BUS_AVB,
+                             (uint8_t *)&val->i3c_bus_avb, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_X_OFS_USR,
+                             &val->x_ofs_usr, 3);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Restore the user bank configuration saved by
+  *         lsm6dso32_state_save.[set]
+  *
+  *         Order: CTRL3_C (reset / boot masked, auto-increment forced),
+  *         accelerometer and gyroscope in power-down, configuration
+  *         registers with FIFO in bypass, then output data rates,
+  *         FIFO mode and the saved CTRL3_C.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      user bank configuration
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_state_restore(const stmdev_ctx_t *ctx,
+                                lsm6dso32_state_t *val)
+{
+  lsm6dso32_fifo_ctrl4_t fifo_ctrl4;
+  lsm6dso32_ctrl3_c_t ctrl3_c;
+  uint8_t buff[8];
+  uint8_t i;
+  int32_t ret;
+
+  ctrl3_c = val->ctrl3_c;
+  ctrl3_c.sw_reset = PROPERTY_DISABLE;
+  ctrl3_c.boot = PROPERTY_DISABLE;
+  ctrl3_c.if_inc = PROPERTY_ENABLE;
+  ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+
+  if (ret == 0)
+  {
+    buff[0] = 0x00U;
+    buff[1] = 0x00U;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL1_XL, buff, 2);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_PIN_CTRL,
+                              (uint8_t *)&val->pin_ctrl, 1);
+  }
+
+  if (ret == 0)
+  {
+    /* FIFO_CTRL1..INT2_CTRL with FIFO in bypass */
+    for (i = 0U; i < 8U; i++)
+    {
+      buff[i] = ((uint8_t *)&val->fifo_ctrl1)[i];
+    }
+
+    fifo_ctrl4 = val->fifo_ctrl4;
+    fifo_ctrl4.fifo_mode = (uint8_t)LSM6DSO32_BYPASS_MODE;
+    buff[LSM6DSO32_FIFO_CTRL4 - LSM6DSO32_FIFO_CTRL1] =
+      *(uint8_t *)&fifo_ctrl4;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FIFO_CTRL1, buff, 8);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL4_C,
+                              (uint8_t *)&val->ctrl4_c, 7);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_TAP_CFG0,
+                              (uint8_t *)&val->tap_cfg0, 10);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_I3C_BUS_AVB,
+                              (uint8_t *)&val->i3c_bus_avb, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_X_OFS_USR,
+                              &val->x_ofs_usr, 3);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL1_XL,
+                              (uint8_t *)&val->ctrl1_xl, 2);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FIFO_CTRL4,
+                              (uint8_t *)&val->fifo_ctrl4, 1);
+  }
+
+  if (ret == 0)
+  {
+    ctrl3_c = val->ctrl3_c;
+    ctrl3_c.sw_reset = PROPERTY_DISABLE;
+    ctrl3_c.boot = PROPERTY_DISABLE;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL3_C,
+                              (uint8_t *)&ctrl3_c, 1);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Start the non-blocking device bring-up.[set]
+  *
+  * @param  init     bring-up state machine
+  * @param  cfg      configuration restored at the end of the bring-up
+  *                  (see lsm6dso32_state_save) or NULL to only enable
+  *                  BDU and register auto-increment
+  *
+  */
+void lsm6dso32_init_start(lsm6dso32_init_t *init, lsm6dso32_state_t *cfg)
+{
+  init->state = LSM6DSO32_INIT_ID_CHECK;
+  init->cfg = cfg;
+  init->wait_ms = 0U;
+  init->backoff_ms = 1U;
+  init->elapsed_ms = 0U;
+}
+
+/**
+  * @brief  Advance the non-blocking device bring-up: ID check,
+  *         software reset, reset / boot completion polling with
+  *         exponential backoff and configuration.[set]
+  *
+  *         To be called from a scheduler tick or event loop; no call
+  *         blocks on mdelay, so several devices can be brought up in
+  *         parallel.
+  *
+  * @param  ctx         read / write interface definitions
+  * @param  init        bring-up state machine
+  * @param  elapsed_ms  time elapsed since the previous call
+  * @param  next_ms     suggested delay before the next call
+  *                     (0 when done or failed)
+  * @retval             interface status, -1 also on wrong WHO_AM_I or
+  *                     reset timeout (state LSM6DSO32_INIT_ERROR);
+  *                     bus errors while polling WHO_AM_I or the reset
+  *                     completion are retried until the timeout
+  *
+  */
+int32_t lsm6dso32_init_step(const stmdev_ctx_t *ctx, lsm6dso32_init_t *init,
+                            uint32_t elapsed_ms, uint32_t *next_ms)
+{
+  lsm6dso32_ctrl3_c_t ctrl3_c;
+  uint8_t poll = PROPERTY_DISABLE;
+  uint8_t whoami;
+  int32_t ret = 0;
+
+  init->elapsed_ms += elapsed_ms;
+  init->wait_ms = (elapsed_ms >= init->wait_ms) ?
+                  0U : (init->wait_ms - elapsed_ms);
+
+  if (init->wait_ms == 0U)
+  {
+    switch (init->state)
+    {
+      case LSM6DSO32_INIT_ID_CHECK:
+        /* the device may be still in power-on boot: retry */
+        if ((lsm6dso32_device_id_get(ctx, &whoami) == 0) &&
+            (whoami == LSM6DSO32_ID))
+        {
+          ret = lsm6dso32_reset_set(ctx, PROPERTY_ENABLE);
+
+          if (ret == 0)
+          {
+            init->state = LSM6DSO32_INIT_RESET_WAIT;
+            init->elapsed_ms = 0U;
+            init->backoff_ms = 1U;
+          }
+        }
+
+        poll = PROPERTY_ENABLE;
+        break;
+
+      case LSM6DSO32_INIT_RESET_WAIT:
+        /* as in ID_CHECK: no answer during reset / boot, retry */
+        if ((lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL3_C,
+                                (uint8_t *)&ctrl3_c, 1) == 0) &&
+            (ctrl3_c.sw_reset == PROPERTY_DISABLE) &&
+            (ctrl3_c.boot == PROPERTY_DISABLE))
+        {
+          init->state = LSM6DSO32_INIT_CONFIG;
+        }
+
+        else
+        {
+          poll = PROPERTY_ENABLE;
+        }
+
+        break;
+
+      default:
+        break;
+    }
+
+    if ((ret == 0) && (init->state == LSM6DSO32_INIT_CONFIG))
+    {
+      if (init->cfg != NULL)
+      {
+        ret = lsm6dso32_state_restore(ctx, init->cfg);
+      }
+
+      else
+      {
+        ret = lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL3_C,
+                                 (uint8_t *)&ctrl3_c, 1);
+
+        if (ret == 0)
+        {
+          ctrl3_c.bdu = PROPERTY_ENABLE;
+          ctrl3_c.if_inc = PROPERTY_ENABLE;
+          ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL3_C,
+                                    (uint8_t *)&ctrl3_c, 1);
+        }
+      }
+
+      if (ret == 0)
+      {
+        init->state = LSM6DSO32_INIT_DONE;
+      }
+    }
+
+    if ((ret == 0) && (poll == PROPERTY_ENABLE))
+    {
+      if (init->elapsed_ms >= LSM6DSO32_INIT_TIMEOUT_MS)
+      {
+        init->state = LSM6DSO32_INIT_ERROR;
+      }
+
+      else
+      {
+        init->wait_ms = init->backoff_ms;
+        init->backoff_ms = (init->backoff_ms < LSM6DSO32_INIT_BACKOFF_MAX_MS) ?
+                           (init->backoff_ms * 2U) : init->backoff_ms;
+      }
+    }
+  }
+
+  if (ret != 0)
+  {
+    init->state = LSM6DSO32_INIT_ERROR;
+  }
+
+  if (init->state == LSM6DSO32_INIT_ERROR)
+  {
+    ret = -1;
+  }
+
+  *next_ms = ((init->state == LSM6DSO32_INIT_DONE) ||
+              (init->state == LSM6DSO32_INIT_ERROR)) ? 0U : init->wait_ms;
+
+  return ret;
+}
+
 /**
   * @brief  Linear acceleration sensor self-test enable.[set]
   *
@@ -2064,10 +2966,278 @@ int32_t lsm6dso32_gy_self_test_get(const stmdev_ctx_t *ctx,
   */
 
 /**
-  * @brief  Accelerometer output from LPF2 filtering stage selection.[set]
+  * @brief  Start the accelerometer and gyroscope self-test
+  *         procedure.[set]
+  *
+  *         The current configuration is saved and restored at the end
+  *         of the procedure (see lsm6dso32_self_test_step).
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      change the values of lpf2_xl_en in reg CTRL1_XL
+  * @param  st       self-test engine
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_self_test_start(const stmdev_ctx_t *ctx,
+                                  lsm6dso32_self_test_t *st)
+{
+  int32_t ret;
+
+  st->state = LSM6DSO32_SELF_TEST_XL_NOST;
+  st->phase = 0U;
+  st->wait_ms = 0U;
+  st->elapsed_ms = 0U;
+  st->xl_pass = PROPERTY_DISABLE;
+  st->gy_pass = PROPERTY_DISABLE;
+  ret = lsm6dso32_state_save(ctx, &st->saved);
+
+  if (ret != 0)
+  {
+    st->state = LSM6DSO32_SELF_TEST_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Advance the self-test procedure.[set]
+  *
+  *         Datasheet procedure (XL 52 Hz @ 4g, GY 208 Hz @ 2000dps):
+  *         for each sensor the output without and with positive
+  *         self-test is averaged over LSM6DSO32_SELF_TEST_SAMPLES
+  *         samples after LSM6DSO32_SELF_TEST_SETTLE_MS. Samples are
+  *         batched in FIFO so that the bus is accessed only once per
+  *         LSM6DSO32_SELF_TEST_POLL_MS. Non-blocking: one engine per
+  *         device allows a group of devices to be tested in parallel.
+  *
+  * @param  ctx         read / write interface definitions
+  * @param  st          self-test engine
+  * @param  elapsed_ms  time elapsed since the previous call
+  * @param  next_ms     suggested delay before the next call
+  *                     (0 when done or failed)
+  * @retval             interface status, -1 also on collection timeout;
+  *                     on error the saved configuration is restored
+  *
+  */
+int32_t lsm6dso32_self_test_step(const stmdev_ctx_t *ctx,
+                                 lsm6dso32_self_test_t *st,
+                                 uint32_t elapsed_ms, uint32_t *next_ms)
+{
+  lsm6dso32_fifo_tag_t tag;
+  lsm6dso32_reg_t ctrl[10];
+  lsm6dso32_reg_t fifo[4];
+  uint8_t word[7];
+  int16_t data[3];
+  float_t avg;
+  float_t val;
+  uint16_t num;
+  uint8_t wtag;
+  uint8_t xl;
+  uint8_t pass;
+  uint8_t i;
+  int32_t ret = 0;
+
+  if ((st->phase == 2U) && (st->state < LSM6DSO32_SELF_TEST_DONE))
+  {
+    /* collection time runs whether or not the poll delay expired */
+    st->elapsed_ms += elapsed_ms;
+  }
+
+  st->wait_ms = (elapsed_ms >= st->wait_ms) ? 0U : (st->wait_ms - elapsed_ms);
+  xl = ((st->state == LSM6DSO32_SELF_TEST_XL_NOST) ||
+        (st->state == LSM6DSO32_SELF_TEST_XL_ST)) ?
+       PROPERTY_ENABLE : PROPERTY_DISABLE;
+  tag = (xl == PROPERTY_ENABLE) ? LSM6DSO32_XL_NC_TAG : LSM6DSO32_GYRO_NC_TAG;
+
+  if ((st->wait_ms == 0U) && (st->state < LSM6DSO32_SELF_TEST_DONE))
+  {
+    if (st->phase == 0U)
+    {
+      /* CTRL1_XL..CTRL10_C, FIFO_CTRL1..4 (no WTM / compression) */
+      for (i = 0U; i < 10U; i++)
+      {
+        ctrl[i].byte = 0x00U;
+      }
+
+      for (i = 0U; i < 4U; i++)
+      {
+        fifo[i].byte = 0x00U;
+      }
+
+      ctrl[2].ctrl3_c.bdu = PROPERTY_ENABLE;
+      ctrl[2].ctrl3_c.if_inc = PROPERTY_ENABLE;
+
+      if (xl == PROPERTY_ENABLE)
+      {
+        ctrl[0].ctrl1_xl.odr_xl = (uint8_t)LSM6DSO32_XL_ODR_52Hz_HIGH_PERF;
+        ctrl[0].ctrl1_xl.fs_xl = (uint8_t)LSM6DSO32_4g;
+        ctrl[4].ctrl5_c.st_xl = (st->state == LSM6DSO32_SELF_TEST_XL_ST) ?
+                                (uint8_t)LSM6DSO32_XL_ST_POSITIVE :
+                                (uint8_t)LSM6DSO32_XL_ST_DISABLE;
+        fifo[2].fifo_ctrl3.bdr_xl = (uint8_t)LSM6DSO32_XL_BATCHED_AT_52Hz;
+      }
+
+      else
+      {
+        ctrl[1].ctrl2_g.odr_g = (uint8_t)LSM6DSO32_GY_ODR_208Hz_HIGH_PERF;
+        ctrl[1].ctrl2_g.fs_g = (uint8_t)LSM6DSO32_2000dps;
+        ctrl[4].ctrl5_c.st_g = (st->state == LSM6DSO32_SELF_TEST_GY_ST) ?
+                               (uint8_t)LSM6DSO32_GY_ST_POSITIVE :
+                               (uint8_t)LSM6DSO32_GY_ST_DISABLE;
+        fifo[2].fifo_ctrl3.bdr_gy = (uint8_t)LSM6DSO32_GY_BATCHED_AT_208Hz;
+      }
+
+      ret = lsm6dso32_write_reg(ctx, LSM6DSO32_CTRL1_XL,
+                                (uint8_t *)ctrl, 10);
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FIFO_CTRL1,
+                                  (uint8_t *)fifo, 4);
+      }
+
+      st->phase = 1U;
+      st->wait_ms = LSM6DSO32_SELF_TEST_SETTLE_MS;
+    }
+
+    else if (st->phase == 1U)
+    {
+      /* output settled: start batching */
+      ret = lsm6dso32_fifo_mode_set(ctx, LSM6DSO32_FIFO_MODE);
+      st->sum[0] = 0;
+      st->sum[1] = 0;
+      st->sum[2] = 0;
+      st->cnt = 0U;
+      st->elapsed_ms = 0U;
+      st->phase = 2U;
+      st->wait_ms = LSM6DSO32_SELF_TEST_POLL_MS;
+    }
+
+    else
+    {
+      ret = lsm6dso32_fifo_data_level_get(ctx, &num);
+
+      if ((ret == 0) && (num > (uint16_t)(LSM6DSO32_SELF_TEST_SAMPLES -
+                                           st->cnt)))
+      {
+        num = (uint16_t)(LSM6DSO32_SELF_TEST_SAMPLES - st->cnt);
+      }
+
+      /* one FIFO word at a time, summed as it is read */
+      for (i = 0U; (ret == 0) && (i < num); i++)
+      {
+        ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FIFO_DATA_OUT_TAG, word, 7);
+
+        if (ret == 0)
+        {
+          lsm6dso32_fifo_words_unpack(word, 1U, &wtag, data);
+        }
+
+        if ((ret == 0) && (wtag == (uint8_t)tag))
+        {
+          st->sum[0] += data[0];
+          st->sum[1] += data[1];
+          st->sum[2] += data[2];
+          st->cnt++;
+        }
+      }
+
+      if ((ret == 0) && (st->cnt >= LSM6DSO32_SELF_TEST_SAMPLES))
+      {
+        pass = PROPERTY_ENABLE;
+
+        for (i = 0U; i < 3U; i++)
+        {
+          avg = (float_t)st->sum[i] / (float_t)st->cnt;
+
+          if ((st->state == LSM6DSO32_SELF_TEST_XL_NOST) ||
+              (st->state == LSM6DSO32_SELF_TEST_GY_NOST))
+          {
+            st->nost[i] = avg;
+          }
+
+          else if (xl == PROPERTY_ENABLE)
+          {
+            val = lsm6dso32_from_fs4_to_mg((int16_t)(avg - st->nost[i]));
+            val = (val < 0.0f) ? -val : val;
+            st->xl_mg[i] = val;
+            pass = ((val >= LSM6DSO32_XL_ST_MIN_MG) &&
+                    (val <= LSM6DSO32_XL_ST_MAX_MG)) ? pass : 0U;
+          }
+
+          else
+          {
+            val = lsm6dso32_from_fs2000_to_mdps((int16_t)(avg - st->nost[i]));
+            val = ((val < 0.0f) ? -val : val) / 1000.0f;
+            st->gy_dps[i] = val;
+            pass = ((val >= LSM6DSO32_GY_ST_MIN_DPS) &&
+                    (val <= LSM6DSO32_GY_ST_MAX_DPS)) ? pass : 0U;
+          }
+        }
+
+        if (st->state == LSM6DSO32_SELF_TEST_XL_ST)
+        {
+          st->xl_pass = pass;
+        }
+
+        else if (st->state == LSM6DSO32_SELF_TEST_GY_ST)
+        {
+          st->gy_pass = pass;
+        }
+
+        else
+        {
+          /* no self-test reference taken */
+        }
+
+        ret = lsm6dso32_fifo_mode_set(ctx, LSM6DSO32_BYPASS_MODE);
+        st->state = (lsm6dso32_self_test_state_t)((uint8_t)st->state + 1U);
+        st->phase = 0U;
+
+        if ((ret == 0) && (st->state == LSM6DSO32_SELF_TEST_DONE))
+        {
+          ret = lsm6dso32_state_restore(ctx, &st->saved);
+        }
+      }
+
+      else if (st->elapsed_ms >= LSM6DSO32_SELF_TEST_TIMEOUT_MS)
+      {
+        ret = -1;
+      }
+
+      else
+      {
+        st->wait_ms = LSM6DSO32_SELF_TEST_POLL_MS;
+      }
+    }
+  }
+
+  if (ret != 0)
+  {
+    /* bus error or timeout: put back the saved CTRL / FIFO registers */
+    (void)lsm6dso32_state_restore(ctx, &st->saved);
+    st->state = LSM6DSO32_SELF_TEST_ERROR;
+  }
+
+  else if (st->state == LSM6DSO32_SELF_TEST_ERROR)
+  {
+    ret = -1;
+  }
+
+  else
+  {
+    /* procedure in progress or done */
+  }
+
+  *next_ms = (st->state < LSM6DSO32_SELF_TEST_DONE) ? st->wait_ms : 0U;
+
+  return ret;
+}
+
+/**
+  * @brief  Accelerometer output from LPF2 filtering stage selection.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      change the values of lpf2_xl_en in reg CTRL1_XL
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
@@ -3017,41 +4187,152 @@ int32_t lsm6dso32_int1_mode_get(const stmdev_ctx_t *ctx,
   return ret;
 }
 
+/* basic interrupts routed on any pad (TAP_CFG2.INTERRUPTS_ENABLE) */
+static uint8_t lsm6dso32_pin_int_basic(const lsm6dso32_pin_int_cache_t *cache)
+{
+  uint8_t val;
+
+  if ((cache->int2_ctrl.int2_cnt_bdr
+       | cache->int2_ctrl.int2_drdy_g
+       | cache->int2_ctrl.int2_drdy_temp
+       | cache->int2_ctrl.int2_drdy_xl
+       | cache->int2_ctrl.int2_fifo_full
+       | cache->int2_ctrl.int2_fifo_ovr
+       | cache->int2_ctrl.int2_fifo_th
+       | cache->md2_cfg.int2_6d
+       | cache->md2_cfg.int2_double_tap
+       | cache->md2_cfg.int2_ff
+       | cache->md2_cfg.int2_wu
+       | cache->md2_cfg.int2_single_tap
+       | cache->md2_cfg.int2_sleep_change
+       | cache->int1_ctrl.den_drdy_flag
+       | cache->int1_ctrl.int1_boot
+       | cache->int1_ctrl.int1_cnt_bdr
+       | cache->int1_ctrl.int1_drdy_g
+       | cache->int1_ctrl.int1_drdy_xl
+       | cache->int1_ctrl.int1_fifo_full
+       | cache->int1_ctrl.int1_fifo_ovr
+       | cache->int1_ctrl.int1_fifo_th
+       | cache->md1_cfg.int1_6d
+       | cache->md1_cfg.int1_double_tap
+       | cache->md1_cfg.int1_ff
+       | cache->md1_cfg.int1_wu
+       | cache->md1_cfg.int1_single_tap
+       | cache->md1_cfg.int1_sleep_change) != PROPERTY_DISABLE)
+  {
+    val = PROPERTY_ENABLE;
+  }
+
+  else
+  {
+    val = PROPERTY_DISABLE;
+  }
+
+  return val;
+}
+
+/* embedded functions routed on INT1 (MD1_CFG.INT1_EMB_FUNC) */
+static uint8_t lsm6dso32_pin_int1_emb(const lsm6dso32_pin_int1_route_t *val)
+{
+  uint8_t emb_func;
+
+  if ((val->emb_func_int1.int1_fsm_lc
+       | val->emb_func_int1.int1_sig_mot
+       | val->emb_func_int1.int1_step_detector
+       | val->emb_func_int1.int1_tilt
+       | val->fsm_int1_a.int1_fsm1
+       | val->fsm_int1_a.int1_fsm2
+       | val->fsm_int1_a.int1_fsm3
+       | val->fsm_int1_a.int1_fsm4
+       | val->fsm_int1_a.int1_fsm5
+       | val->fsm_int1_a.int1_fsm6
+       | val->fsm_int1_a.int1_fsm7
+       | val->fsm_int1_a.int1_fsm8
+       | val->fsm_int1_b.int1_fsm9
+       | val->fsm_int1_b.int1_fsm10
+       | val->fsm_int1_b.int1_fsm11
+       | val->fsm_int1_b.int1_fsm12
+       | val->fsm_int1_b.int1_fsm13
+       | val->fsm_int1_b.int1_fsm14
+       | val->fsm_int1_b.int1_fsm15
+       | val->fsm_int1_b.int1_fsm16) != PROPERTY_DISABLE)
+  {
+    emb_func = PROPERTY_ENABLE;
+  }
+
+  else
+  {
+    emb_func = PROPERTY_DISABLE;
+  }
+
+  return emb_func;
+}
+
+/* embedded functions routed on INT2 (MD2_CFG.INT2_EMB_FUNC) */
+static uint8_t lsm6dso32_pin_int2_emb(const lsm6dso32_pin_int2_route_t *val)
+{
+  uint8_t emb_func;
+
+  if ((val->emb_func_int2.int2_fsm_lc
+       | val->emb_func_int2.int2_sig_mot
+       | val->emb_func_int2.int2_step_detector
+       | val->emb_func_int2.int2_tilt
+       | val->fsm_int2_a.int2_fsm1
+       | val->fsm_int2_a.int2_fsm2
+       | val->fsm_int2_a.int2_fsm3
+       | val->fsm_int2_a.int2_fsm4
+       | val->fsm_int2_a.int2_fsm5
+       | val->fsm_int2_a.int2_fsm6
+       | val->fsm_int2_a.int2_fsm7
+       | val->fsm_int2_a.int2_fsm8
+       | val->fsm_int2_b.int2_fsm9
+       | val->fsm_int2_b.int2_fsm10
+       | val->fsm_int2_b.int2_fsm11
+       | val->fsm_int2_b.int2_fsm12
+       | val->fsm_int2_b.int2_fsm13
+       | val->fsm_int2_b.int2_fsm14
+       | val->fsm_int2_b.int2_fsm15
+       | val->fsm_int2_b.int2_fsm16) != PROPERTY_DISABLE)
+  {
+    emb_func = PROPERTY_ENABLE;
+  }
+
+  else
+  {
+    emb_func = PROPERTY_DISABLE;
+  }
+
+  return emb_func;
+}
+
 /**
-  * @brief  Select the signal that need to route on int1 pad.[set]
+  * @brief  Load the interrupt routing cache from the device.[get]
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      struct of registers: INT1_CTRL,
-  *                  MD1_CFG, EMB_FUNC_INT1, FSM_INT1_A,
-  *                  FSM_INT1_B
+  * @param  val      INT1_CTRL, INT2_CTRL, MD1_CFG, MD2_CFG,
+  *                  TAP_CFG2 interrupts enable and the embedded
+  *                  functions routing of both pads
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
-int32_t lsm6dso32_pin_int1_route_set(const stmdev_ctx_t *ctx,
-                                     lsm6dso32_pin_int1_route_t *val)
+int32_t lsm6dso32_pin_int_cache_init(const stmdev_ctx_t *ctx,
+                                     lsm6dso32_pin_int_cache_t *val)
 {
-  lsm6dso32_pin_int2_route_t pin_int2_route;
-  lsm6dso32_tap_cfg2_t tap_cfg2;
+  lsm6dso32_reg_t reg[2];
   int32_t ret;
 
+  val->emb_int1_valid = PROPERTY_DISABLE;
+  val->emb_int2_valid = PROPERTY_DISABLE;
   ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
 
   if (ret == 0)
   {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_INT1,
-                              (uint8_t *)&val->emb_func_int1, 1);
-  }
-
-  if (ret == 0)
-  {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FSM_INT1_A,
-                              (uint8_t *)&val->fsm_int1_a, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT1, val->emb_int1, 3);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FSM_INT1_B,
-                              (uint8_t *)&val->fsm_int1_b, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT2, val->emb_int2, 3);
   }
 
   if (ret == 0)
@@ -3061,227 +4342,215 @@ int32_t lsm6dso32_pin_int1_route_set(const stmdev_ctx_t *ctx,
 
   if (ret == 0)
   {
-    if ((val->emb_func_int1.int1_fsm_lc
-         | val->emb_func_int1.int1_sig_mot
-         | val->emb_func_int1.int1_step_detector
-         | val->emb_func_int1.int1_tilt
-         | val->fsm_int1_a.int1_fsm1
-         | val->fsm_int1_a.int1_fsm2
-         | val->fsm_int1_a.int1_fsm3
-         | val->fsm_int1_a.int1_fsm4
-         | val->fsm_int1_a.int1_fsm5
-         | val->fsm_int1_a.int1_fsm6
-         | val->fsm_int1_a.int1_fsm7
-         | val->fsm_int1_a.int1_fsm8
-         | val->fsm_int1_b.int1_fsm9
-         | val->fsm_int1_b.int1_fsm10
-         | val->fsm_int1_b.int1_fsm11
-         | val->fsm_int1_b.int1_fsm12
-         | val->fsm_int1_b.int1_fsm13
-         | val->fsm_int1_b.int1_fsm14
-         | val->fsm_int1_b.int1_fsm15
-         | val->fsm_int1_b.int1_fsm16) != PROPERTY_DISABLE)
-    {
-      val->md1_cfg.int1_emb_func = PROPERTY_ENABLE;
-    }
-
-    else
-    {
-      val->md1_cfg.int1_emb_func = PROPERTY_DISABLE;
-    }
-
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_INT1_CTRL,
-                              (uint8_t *)&val->int1_ctrl, 1);
-  }
-
-  if (ret == 0)
-  {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MD1_CFG,
-                              (uint8_t *)&val->md1_cfg, 1);
+    val->emb_int1_valid = PROPERTY_ENABLE;
+    val->emb_int2_valid = PROPERTY_ENABLE;
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT1_CTRL, (uint8_t *)reg, 2);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG2,
-                             (uint8_t *) &tap_cfg2, 1);
+    val->int1_ctrl = reg[0].int1_ctrl;
+    val->int2_ctrl = reg[1].int2_ctrl;
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD1_CFG, (uint8_t *)reg, 2);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_pin_int2_route_get(ctx, &pin_int2_route);
+    val->md1_cfg = reg[0].md1_cfg;
+    val->md2_cfg = reg[1].md2_cfg;
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG2, (uint8_t *)reg, 1);
   }
 
   if (ret == 0)
   {
-    if ((pin_int2_route.int2_ctrl.int2_cnt_bdr
-         | pin_int2_route.int2_ctrl.int2_drdy_g
-         | pin_int2_route.int2_ctrl.int2_drdy_temp
-         | pin_int2_route.int2_ctrl.int2_drdy_xl
-         | pin_int2_route.int2_ctrl.int2_fifo_full
-         | pin_int2_route.int2_ctrl.int2_fifo_ovr
-         | pin_int2_route.int2_ctrl.int2_fifo_th
-         | pin_int2_route.md2_cfg.int2_6d
-         | pin_int2_route.md2_cfg.int2_double_tap
-         | pin_int2_route.md2_cfg.int2_ff
-         | pin_int2_route.md2_cfg.int2_wu
-         | pin_int2_route.md2_cfg.int2_single_tap
-         | pin_int2_route.md2_cfg.int2_sleep_change
-         | val->int1_ctrl.den_drdy_flag
-         | val->int1_ctrl.int1_boot
-         | val->int1_ctrl.int1_cnt_bdr
-         | val->int1_ctrl.int1_drdy_g
-         | val->int1_ctrl.int1_drdy_xl
-         | val->int1_ctrl.int1_fifo_full
-         | val->int1_ctrl.int1_fifo_ovr
-         | val->int1_ctrl.int1_fifo_th
-         | val->md1_cfg.int1_6d
-         | val->md1_cfg.int1_double_tap
-         | val->md1_cfg.int1_ff
-         | val->md1_cfg.int1_wu
-         | val->md1_cfg.int1_single_tap
-         | val->md1_cfg.int1_sleep_change) != PROPERTY_DISABLE)
-    {
-      tap_cfg2.interrupts_enable = PROPERTY_ENABLE;
-    }
-
-    else
-    {
-      tap_cfg2.interrupts_enable = PROPERTY_DISABLE;
-    }
-
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_TAP_CFG2,
-                              (uint8_t *) &tap_cfg2, 1);
+    val->interrupts_enable = reg[0].tap_cfg2.interrupts_enable;
   }
 
   return ret;
 }
 
 /**
-  * @brief  Select the signal that need to route on int1 pad.[get]
+  * @brief  Select the signal that need to route on int1 pad, using the
+  *         routing cache instead of reading back the int2 pad.[set]
+  *
+  *         No register is read unless the basic interrupts enable
+  *         (TAP_CFG2) has to change, so the call has a bounded stack
+  *         depth and no nested route read. The embedded functions bank
+  *         is accessed only when EMB_FUNC_INT1 / FSM_INT1_A / FSM_INT1_B
+  *         differ from the cache.
   *
   * @param  ctx      read / write interface definitions
+  * @param  cache    routing cache (lsm6dso32_pin_int_cache_init)
   * @param  val      struct of registers: INT1_CTRL, MD1_CFG,
   *                  EMB_FUNC_INT1, FSM_INT1_A, FSM_INT1_B
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
-int32_t lsm6dso32_pin_int1_route_get(const stmdev_ctx_t *ctx,
-                                     lsm6dso32_pin_int1_route_t *val)
+int32_t lsm6dso32_pin_int1_route_cached_set(const stmdev_ctx_t *ctx,
+                                            lsm6dso32_pin_int_cache_t *cache,
+                                            lsm6dso32_pin_int1_route_t *val)
 {
-  int32_t ret;
+  lsm6dso32_tap_cfg2_t tap_cfg2;
+  lsm6dso32_reg_t emb[3];
+  uint8_t emb_diff;
+  uint8_t int_en;
+  uint8_t i;
+  int32_t ret = 0;
 
-  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+  emb[0].emb_func_int1 = val->emb_func_int1;
+  emb[1].fsm_int1_a = val->fsm_int1_a;
+  emb[2].fsm_int1_b = val->fsm_int1_b;
+  emb_diff = (cache->emb_int1_valid == PROPERTY_ENABLE) ?
+             PROPERTY_DISABLE : PROPERTY_ENABLE;
 
-  if (ret == 0)
+  for (i = 0U; i < 3U; i++)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT1,
-                             (uint8_t *)&val->emb_func_int1, 1);
+    if (emb[i].byte != cache->emb_int1[i])
+    {
+      emb_diff = PROPERTY_ENABLE;
+    }
   }
 
-  if (ret == 0)
+  if (emb_diff == PROPERTY_ENABLE)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT1_A,
-                             (uint8_t *)&val->fsm_int1_a, 1);
-  }
+    cache->emb_int1_valid = PROPERTY_DISABLE;
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
 
-  if (ret == 0)
-  {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT1_B,
-                             (uint8_t *)&val->fsm_int1_b, 1);
+    if (ret == 0)
+    {
+      ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_INT1,
+                                (uint8_t *)emb, 3);
+    }
+
+    if (ret == 0)
+    {
+      ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+    }
+
+    if (ret == 0)
+    {
+      for (i = 0U; i < 3U; i++)
+      {
+        cache->emb_int1[i] = emb[i].byte;
+      }
+
+      cache->emb_int1_valid = PROPERTY_ENABLE;
+    }
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+    val->md1_cfg.int1_emb_func = lsm6dso32_pin_int1_emb(val);
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_INT1_CTRL,
+                              (uint8_t *)&val->int1_ctrl, 1);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT1_CTRL,
-                             (uint8_t *)&val->int1_ctrl, 1);
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MD1_CFG,
+                              (uint8_t *)&val->md1_cfg, 1);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD1_CFG,
-                             (uint8_t *)&val->md1_cfg, 1);
+    cache->int1_ctrl = val->int1_ctrl;
+    cache->md1_cfg = val->md1_cfg;
+    int_en = lsm6dso32_pin_int_basic(cache);
+
+    if (int_en != cache->interrupts_enable)
+    {
+      ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG2,
+                               (uint8_t *) &tap_cfg2, 1);
+
+      if (ret == 0)
+      {
+        tap_cfg2.interrupts_enable = int_en;
+        ret = lsm6dso32_write_reg(ctx, LSM6DSO32_TAP_CFG2,
+                                  (uint8_t *) &tap_cfg2, 1);
+      }
+
+      if (ret == 0)
+      {
+        cache->interrupts_enable = int_en;
+      }
+    }
   }
 
   return ret;
 }
 
 /**
-  * @brief  Select the signal that need to route on int2 pad.[set]
+  * @brief  Select the signal that need to route on int2 pad, using the
+  *         routing cache instead of reading back the int1 pad.[set]
+  *
+  *         No register is read unless the basic interrupts enable
+  *         (TAP_CFG2) has to change, so the call has a bounded stack
+  *         depth and no nested route read. The embedded functions bank
+  *         is accessed only when EMB_FUNC_INT2 / FSM_INT2_A / FSM_INT2_B
+  *         differ from the cache.
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      union of registers INT2_CTRL,  MD2_CFG,
+  * @param  cache    routing cache (lsm6dso32_pin_int_cache_init)
+  * @param  val      struct of registers: INT2_CTRL, MD2_CFG,
   *                  EMB_FUNC_INT2, FSM_INT2_A, FSM_INT2_B
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
-int32_t lsm6dso32_pin_int2_route_set(const stmdev_ctx_t *ctx,
-                                     lsm6dso32_pin_int2_route_t *val)
+int32_t lsm6dso32_pin_int2_route_cached_set(const stmdev_ctx_t *ctx,
+                                            lsm6dso32_pin_int_cache_t *cache,
+                                            lsm6dso32_pin_int2_route_t *val)
 {
-  lsm6dso32_pin_int1_route_t pin_int1_route;
   lsm6dso32_tap_cfg2_t tap_cfg2;
-  int32_t ret;
-
-  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+  lsm6dso32_reg_t emb[3];
+  uint8_t emb_diff;
+  uint8_t int_en;
+  uint8_t i;
+  int32_t ret = 0;
 
-  if (ret == 0)
-  {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_INT2,
-                              (uint8_t *)&val->emb_func_int2, 1);
-  }
+  emb[0].emb_func_int2 = val->emb_func_int2;
+  emb[1].fsm_int2_a = val->fsm_int2_a;
+  emb[2].fsm_int2_b = val->fsm_int2_b;
+  emb_diff = (cache->emb_int2_valid == PROPERTY_ENABLE) ?
+             PROPERTY_DISABLE : PROPERTY_ENABLE;
 
-  if (ret == 0)
+  for (i = 0U; i < 3U; i++)
   {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FSM_INT2_A,
-                              (uint8_t *)&val->fsm_int2_a, 1);
+    if (emb[i].byte != cache->emb_int2[i])
+    {
+      emb_diff = PROPERTY_ENABLE;
+    }
   }
 
-  if (ret == 0)
+  if (emb_diff == PROPERTY_ENABLE)
   {
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_FSM_INT2_B,
-                              (uint8_t *)&val->fsm_int2_b, 1);
-  }
+    cache->emb_int2_valid = PROPERTY_DISABLE;
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
 
-  if (ret == 0)
-  {
-    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
-  }
+    if (ret == 0)
+    {
+      ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_INT2,
+                                (uint8_t *)emb, 3);
+    }
 
-  if (ret == 0)
-  {
-    if ((val->emb_func_int2.int2_fsm_lc
-         | val->emb_func_int2.int2_sig_mot
-         | val->emb_func_int2.int2_step_detector
-         | val->emb_func_int2.int2_tilt
-         | val->fsm_int2_a.int2_fsm1
-         | val->fsm_int2_a.int2_fsm2
-         | val->fsm_int2_a.int2_fsm3
-         | val->fsm_int2_a.int2_fsm4
-         | val->fsm_int2_a.int2_fsm5
-         | val->fsm_int2_a.int2_fsm6
-         | val->fsm_int2_a.int2_fsm7
-         | val->fsm_int2_a.int2_fsm8
-         | val->fsm_int2_b.int2_fsm9
-         | val->fsm_int2_b.int2_fsm10
-         | val->fsm_int2_b.int2_fsm11
-         | val->fsm_int2_b.int2_fsm12
-         | val->fsm_int2_b.int2_fsm13
-         | val->fsm_int2_b.int2_fsm14
-         | val->fsm_int2_b.int2_fsm15
-         | val->fsm_int2_b.int2_fsm16) != PROPERTY_DISABLE)
+    if (ret == 0)
     {
-      val->md2_cfg.int2_emb_func = PROPERTY_ENABLE;
+      ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
     }
 
-    else
+    if (ret == 0)
     {
-      val->md2_cfg.int2_emb_func = PROPERTY_DISABLE;
+      for (i = 0U; i < 3U; i++)
+      {
+        cache->emb_int2[i] = emb[i].byte;
+      }
+
+      cache->emb_int2_valid = PROPERTY_ENABLE;
     }
+  }
 
+  if (ret == 0)
+  {
+    val->md2_cfg.int2_emb_func = lsm6dso32_pin_int2_emb(val);
     ret = lsm6dso32_write_reg(ctx, LSM6DSO32_INT2_CTRL,
                               (uint8_t *)&val->int2_ctrl, 1);
   }
@@ -3294,71 +4563,80 @@ int32_t lsm6dso32_pin_int2_route_set(const stmdev_ctx_t *ctx,
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG2,
-                             (uint8_t *) &tap_cfg2, 1);
+    cache->int2_ctrl = val->int2_ctrl;
+    cache->md2_cfg = val->md2_cfg;
+    int_en = lsm6dso32_pin_int_basic(cache);
+
+    if (int_en != cache->interrupts_enable)
+    {
+      ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG2,
+                               (uint8_t *) &tap_cfg2, 1);
+
+      if (ret == 0)
+      {
+        tap_cfg2.interrupts_enable = int_en;
+        ret = lsm6dso32_write_reg(ctx, LSM6DSO32_TAP_CFG2,
+                                  (uint8_t *) &tap_cfg2, 1);
+      }
+
+      if (ret == 0)
+      {
+        cache->interrupts_enable = int_en;
+      }
+    }
   }
 
+  return ret;
+}
+
+/**
+  * @brief  Select the signal that need to route on int1 pad.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      struct of registers: INT1_CTRL,
+  *                  MD1_CFG, EMB_FUNC_INT1, FSM_INT1_A,
+  *                  FSM_INT1_B
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_pin_int1_route_set(const stmdev_ctx_t *ctx,
+                                     lsm6dso32_pin_int1_route_t *val)
+{
+  lsm6dso32_pin_int_cache_t cache;
+  int32_t ret;
+
+  /* only the int2 pad basic routing is needed for TAP_CFG2 */
+  cache.emb_int1_valid = PROPERTY_DISABLE;
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT2_CTRL,
+                           (uint8_t *)&cache.int2_ctrl, 1);
+
   if (ret == 0)
   {
-    ret = lsm6dso32_pin_int1_route_get(ctx, &pin_int1_route);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD2_CFG,
+                             (uint8_t *)&cache.md2_cfg, 1);
   }
 
   if (ret == 0)
   {
-    if ((val->int2_ctrl.int2_cnt_bdr
-         | val->int2_ctrl.int2_drdy_g
-         | val->int2_ctrl.int2_drdy_temp
-         | val->int2_ctrl.int2_drdy_xl
-         | val->int2_ctrl.int2_fifo_full
-         | val->int2_ctrl.int2_fifo_ovr
-         | val->int2_ctrl.int2_fifo_th
-         | val->md2_cfg.int2_6d
-         | val->md2_cfg.int2_double_tap
-         | val->md2_cfg.int2_ff
-         | val->md2_cfg.int2_wu
-         | val->md2_cfg.int2_single_tap
-         | val->md2_cfg.int2_sleep_change
-         | pin_int1_route.int1_ctrl.den_drdy_flag
-         | pin_int1_route.int1_ctrl.int1_boot
-         | pin_int1_route.int1_ctrl.int1_cnt_bdr
-         | pin_int1_route.int1_ctrl.int1_drdy_g
-         | pin_int1_route.int1_ctrl.int1_drdy_xl
-         | pin_int1_route.int1_ctrl.int1_fifo_full
-         | pin_int1_route.int1_ctrl.int1_fifo_ovr
-         | pin_int1_route.int1_ctrl.int1_fifo_th
-         | pin_int1_route.md1_cfg.int1_6d
-         | pin_int1_route.md1_cfg.int1_double_tap
-         | pin_int1_route.md1_cfg.int1_ff
-         | pin_int1_route.md1_cfg.int1_wu
-         | pin_int1_route.md1_cfg.int1_single_tap
-         | pin_int1_route.md1_cfg.int1_sleep_change) != PROPERTY_DISABLE)
-    {
-      tap_cfg2.interrupts_enable = PROPERTY_ENABLE;
-    }
-
-    else
-    {
-      tap_cfg2.interrupts_enable = PROPERTY_DISABLE;
-    }
-
-    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_TAP_CFG2,
-                              (uint8_t *) &tap_cfg2, 1);
+    /* unknown: TAP_CFG2 is always updated */
+    cache.interrupts_enable = 0xFFU;
+    ret = lsm6dso32_pin_int1_route_cached_set(ctx, &cache, val);
   }
 
   return ret;
 }
 
 /**
-  * @brief  Select the signal that need to route on int2 pad.[get]
+  * @brief  Select the signal that need to route on int1 pad.[get]
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      union of registers INT2_CTRL,  MD2_CFG,
-  *                  EMB_FUNC_INT2, FSM_INT2_A, FSM_INT2_B
+  * @param  val      struct of registers: INT1_CTRL, MD1_CFG,
+  *                  EMB_FUNC_INT1, FSM_INT1_A, FSM_INT1_B
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
-int32_t lsm6dso32_pin_int2_route_get(const stmdev_ctx_t *ctx,
-                                     lsm6dso32_pin_int2_route_t *val)
+int32_t lsm6dso32_pin_int1_route_get(const stmdev_ctx_t *ctx,
+                                     lsm6dso32_pin_int1_route_t *val)
 {
   int32_t ret;
 
@@ -3366,20 +4644,20 @@ int32_t lsm6dso32_pin_int2_route_get(const stmdev_ctx_t *ctx,
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT2,
-                             (uint8_t *)&val->emb_func_int2, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT1,
+                             (uint8_t *)&val->emb_func_int1, 1);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT2_A,
-                             (uint8_t *)&val->fsm_int2_a, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT1_A,
+                             (uint8_t *)&val->fsm_int1_a, 1);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT2_B,
-                             (uint8_t *)&val->fsm_int2_b, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT1_B,
+                             (uint8_t *)&val->fsm_int1_b, 1);
   }
 
   if (ret == 0)
@@ -3389,24 +4667,425 @@ int32_t lsm6dso32_pin_int2_route_get(const stmdev_ctx_t *ctx,
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT2_CTRL,
-                             (uint8_t *)&val->int2_ctrl, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT1_CTRL,
+                             (uint8_t *)&val->int1_ctrl, 1);
   }
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD2_CFG,
-                             (uint8_t *)&val->md2_cfg, 1);
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD1_CFG,
+                             (uint8_t *)&val->md1_cfg, 1);
   }
 
   return ret;
 }
 
 /**
-  * @brief  Push-pull/open drain selection on interrupt pads.[set]
+  * @brief  Select the signal that need to route on int2 pad.[set]
   *
   * @param  ctx      read / write interface definitions
-  * @param  val      change the values of pp_od in reg CTRL3_C
+  * @param  val      union of registers INT2_CTRL,  MD2_CFG,
+  *                  EMB_FUNC_INT2, FSM_INT2_A, FSM_INT2_B
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_pin_int2_route_set(const stmdev_ctx_t *ctx,
+                                     lsm6dso32_pin_int2_route_t *val)
+{
+  lsm6dso32_pin_int_cache_t cache;
+  int32_t ret;
+
+  /* only the int1 pad basic routing is needed for TAP_CFG2 */
+  cache.emb_int2_valid = PROPERTY_DISABLE;
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT1_CTRL,
+                           (uint8_t *)&cache.int1_ctrl, 1);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD1_CFG,
+                             (uint8_t *)&cache.md1_cfg, 1);
+  }
+
+  if (ret == 0)
+  {
+    /* unknown: TAP_CFG2 is always updated */
+    cache.interrupts_enable = 0xFFU;
+    ret = lsm6dso32_pin_int2_route_cached_set(ctx, &cache, val);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Select the signal that need to route on int2 pad.[get]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      union of registers INT2_CTRL,  MD2_CFG,
+  *                  EMB_FUNC_INT2, FSM_INT2_A, FSM_INT2_B
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_pin_int2_route_get(const stmdev_ctx_t *ctx,
+                                     lsm6dso32_pin_int2_route_t *val)
+{
+  int32_t ret;
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT2,
+                             (uint8_t *)&val->emb_func_int2, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT2_A,
+                             (uint8_t *)&val->fsm_int2_a, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_INT2_B,
+                             (uint8_t *)&val->fsm_int2_b, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT2_CTRL,
+                             (uint8_t *)&val->int2_ctrl, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD2_CFG,
+                             (uint8_t *)&val->md2_cfg, 1);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Select the signals that need to route on int1 and int2
+  *         pads in one pass.[set]
+  *
+  *         One embedded functions bank session with two bursts
+  *         (EMB_FUNC_INT1..FSM_INT1_B, EMB_FUNC_INT2..FSM_INT2_B), then
+  *         INT1_CTRL..INT2_CTRL and MD1_CFG..MD2_CFG bursts and a single
+  *         TAP_CFG2 read-modify-write. MD1_CFG / MD2_CFG embedded
+  *         functions bits are computed from val as in the single pad
+  *         setters. The whole routing is written, so the cache is
+  *         refreshed from val; on error it must be loaded again with
+  *         lsm6dso32_pin_int_cache_init.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  cache    routing cache used by the cached setters,
+  *                  may be NULL
+  * @param  val      routing of both pads
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_pin_int_route_set(const stmdev_ctx_t *ctx,
+                                    lsm6dso32_pin_int_cache_t *cache,
+                                    lsm6dso32_pin_int_route_t *val)
+{
+  lsm6dso32_pin_int_cache_t local;
+  lsm6dso32_pin_int_cache_t *pads;
+  lsm6dso32_reg_t reg[3];
+  uint8_t i;
+  int32_t ret;
+
+  pads = (cache != NULL) ? cache : &local;
+  pads->emb_int1_valid = PROPERTY_DISABLE;
+  pads->emb_int2_valid = PROPERTY_DISABLE;
+  /* unknown until TAP_CFG2 is written */
+  pads->interrupts_enable = 0xFFU;
+  val->int1.md1_cfg.int1_emb_func = lsm6dso32_pin_int1_emb(&val->int1);
+  val->int2.md2_cfg.int2_emb_func = lsm6dso32_pin_int2_emb(&val->int2);
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+
+  if (ret == 0)
+  {
+    reg[0].emb_func_int1 = val->int1.emb_func_int1;
+    reg[1].fsm_int1_a = val->int1.fsm_int1_a;
+    reg[2].fsm_int1_b = val->int1.fsm_int1_b;
+
+    for (i = 0U; i < 3U; i++)
+    {
+      pads->emb_int1[i] = reg[i].byte;
+    }
+
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_INT1,
+                              (uint8_t *)reg, 3);
+  }
+
+  if (ret == 0)
+  {
+    reg[0].emb_func_int2 = val->int2.emb_func_int2;
+    reg[1].fsm_int2_a = val->int2.fsm_int2_a;
+    reg[2].fsm_int2_b = val->int2.fsm_int2_b;
+
+    for (i = 0U; i < 3U; i++)
+    {
+      pads->emb_int2[i] = reg[i].byte;
+    }
+
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_EMB_FUNC_INT2,
+                              (uint8_t *)reg, 3);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  if (ret == 0)
+  {
+    pads->emb_int1_valid = PROPERTY_ENABLE;
+    pads->emb_int2_valid = PROPERTY_ENABLE;
+    reg[0].int1_ctrl = val->int1.int1_ctrl;
+    reg[1].int2_ctrl = val->int2.int2_ctrl;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_INT1_CTRL, (uint8_t *)reg, 2);
+  }
+
+  if (ret == 0)
+  {
+    reg[0].md1_cfg = val->int1.md1_cfg;
+    reg[1].md2_cfg = val->int2.md2_cfg;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MD1_CFG, (uint8_t *)reg, 2);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG2, (uint8_t *)reg, 1);
+  }
+
+  if (ret == 0)
+  {
+    pads->int1_ctrl = val->int1.int1_ctrl;
+    pads->md1_cfg = val->int1.md1_cfg;
+    pads->int2_ctrl = val->int2.int2_ctrl;
+    pads->md2_cfg = val->int2.md2_cfg;
+    reg[0].tap_cfg2.interrupts_enable = lsm6dso32_pin_int_basic(pads);
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_TAP_CFG2, (uint8_t *)reg, 1);
+  }
+
+  if (ret == 0)
+  {
+    pads->interrupts_enable = reg[0].tap_cfg2.interrupts_enable;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Select the signals that need to route on int1 and int2
+  *         pads in one pass.[get]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      routing of both pads
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_pin_int_route_get(const stmdev_ctx_t *ctx,
+                                    lsm6dso32_pin_int_route_t *val)
+{
+  lsm6dso32_reg_t reg[3];
+  int32_t ret;
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT1, (uint8_t *)reg, 3);
+    val->int1.emb_func_int1 = reg[0].emb_func_int1;
+    val->int1.fsm_int1_a = reg[1].fsm_int1_a;
+    val->int1.fsm_int1_b = reg[2].fsm_int1_b;
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_INT2, (uint8_t *)reg, 3);
+    val->int2.emb_func_int2 = reg[0].emb_func_int2;
+    val->int2.fsm_int2_a = reg[1].fsm_int2_a;
+    val->int2.fsm_int2_b = reg[2].fsm_int2_b;
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_INT1_CTRL, (uint8_t *)reg, 2);
+    val->int1.int1_ctrl = reg[0].int1_ctrl;
+    val->int2.int2_ctrl = reg[1].int2_ctrl;
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MD1_CFG, (uint8_t *)reg, 2);
+    val->int1.md1_cfg = reg[0].md1_cfg;
+    val->int2.md2_cfg = reg[1].md2_cfg;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Source registers to read to acknowledge the routed
+  *         interrupts.[get]
+  *
+  *         The mask is computed once when routing is configured, so the
+  *         interrupt handler only runs lsm6dso32_int_ack.
+  *         With INT_CLR_ON_READ reading ALL_INT_SRC alone releases the
+  *         latch of the basic interrupts: WAKE_UP_SRC, TAP_SRC and
+  *         D6D_SRC are only needed to identify the event (axis, sign,
+  *         position). LSM6DSO32_ACK_MINIMAL limits the user bank burst
+  *         to ALL_INT_SRC; the embedded functions status is read as in
+  *         the other mode.
+  *
+  * @param  route    routing of both pads (unused pad cleared)
+  * @param  mode     LSM6DSO32_ACK_WITH_SOURCES, LSM6DSO32_ACK_MINIMAL
+  * @param  val      ALL_INT_SRC and EMB_FUNC_STATUS_MAINPAGE burst lengths
+  *
+  */
+void lsm6dso32_int_ack_mask_get(const lsm6dso32_pin_int_route_t *route,
+                                lsm6dso32_int_ack_mode_t mode,
+                                lsm6dso32_int_ack_mask_t *val)
+{
+  const lsm6dso32_md1_cfg_t *md1 = &route->int1.md1_cfg;
+  const lsm6dso32_md2_cfg_t *md2 = &route->int2.md2_cfg;
+  lsm6dso32_reg_t fsm[4];
+
+  val->user_len = 0U;
+  val->emb_len = 0U;
+
+  /* ALL_INT_SRC, WAKE_UP_SRC, TAP_SRC, D6D_SRC */
+  if ((md1->int1_wu | md1->int1_ff | md1->int1_sleep_change |
+       md2->int2_wu | md2->int2_ff | md2->int2_sleep_change) != 0U)
+  {
+    val->user_len = 2U;
+  }
+
+  if ((md1->int1_single_tap | md1->int1_double_tap |
+       md2->int2_single_tap | md2->int2_double_tap) != 0U)
+  {
+    val->user_len = 3U;
+  }
+
+  if ((md1->int1_6d | md2->int2_6d) != 0U)
+  {
+    val->user_len = 4U;
+  }
+
+  if ((mode == LSM6DSO32_ACK_MINIMAL) && (val->user_len > 1U))
+  {
+    val->user_len = 1U;
+  }
+
+  /* EMB_FUNC_STATUS, FSM_STATUS_A, FSM_STATUS_B (main page copies) */
+  fsm[0].emb_func_int1 = route->int1.emb_func_int1;
+  fsm[1].emb_func_int2 = route->int2.emb_func_int2;
+
+  if ((fsm[0].byte | fsm[1].byte) != 0U)
+  {
+    val->emb_len = 1U;
+  }
+
+  fsm[0].fsm_int1_a = route->int1.fsm_int1_a;
+  fsm[1].fsm_int2_a = route->int2.fsm_int2_a;
+
+  if ((fsm[0].byte | fsm[1].byte) != 0U)
+  {
+    val->emb_len = 2U;
+  }
+
+  fsm[2].fsm_int1_b = route->int1.fsm_int1_b;
+  fsm[3].fsm_int2_b = route->int2.fsm_int2_b;
+
+  if ((fsm[2].byte | fsm[3].byte) != 0U)
+  {
+    val->emb_len = 3U;
+  }
+}
+
+/**
+  * @brief  Read and clear the latched sources of the routed
+  *         interrupts.[get]
+  *
+  *         One burst from ALL_INT_SRC and one from
+  *         EMB_FUNC_STATUS_MAINPAGE, only as long as the mask requires;
+  *         both are in the user bank, no bank switch is done. With
+  *         lsm6dso32_int_notification_set in latched mode INT_CLR_ON_READ
+  *         is set, so the latch is released by these reads.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  mask     from lsm6dso32_int_ack_mask_get
+  * @param  val      sources read (registers not read are cleared)
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_int_ack(const stmdev_ctx_t *ctx,
+                          const lsm6dso32_int_ack_mask_t *mask,
+                          lsm6dso32_all_sources_t *val)
+{
+  lsm6dso32_reg_t reg[4];
+  uint8_t len;
+  uint8_t i;
+  int32_t ret = 0;
+
+  for (i = 0U; i < 4U; i++)
+  {
+    reg[i].byte = 0U;
+  }
+
+  /* at least ALL_INT_SRC when nothing latched is routed */
+  len = ((mask->user_len == 0U) && (mask->emb_len == 0U)) ?
+        1U : mask->user_len;
+
+  if (len != 0U)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_ALL_INT_SRC, (uint8_t *)reg, len);
+  }
+
+  val->all_int_src = reg[0].all_int_src;
+  val->wake_up_src = reg[1].wake_up_src;
+  val->tap_src = reg[2].tap_src;
+  val->d6d_src = reg[3].d6d_src;
+  reg[0].byte = 0U;
+  val->status_reg = reg[0].status_reg;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    reg[i].byte = 0U;
+  }
+
+  if ((ret == 0) && (mask->emb_len != 0U))
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_STATUS_MAINPAGE,
+                             (uint8_t *)reg, mask->emb_len);
+  }
+
+  val->emb_func_status = reg[0].emb_func_status;
+  val->fsm_status_a = reg[1].fsm_status_a;
+  val->fsm_status_b = reg[2].fsm_status_b;
+
+  return ret;
+}
+
+/**
+  * @brief  Push-pull/open drain selection on interrupt pads.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      change the values of pp_od in reg CTRL3_C
   * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
@@ -4141,6 +5820,8 @@ int32_t lsm6dso32_act_sleep_dur_get(const stmdev_ctx_t *ctx, uint8_t *val)
   *
   */
 
+#if LSM6DSO32_FEATURE_TAP
+
 /**
   * @defgroup  LSM6DSO32_tap_generator
   * @brief     This section groups all the functions that manage the
@@ -4977,6 +6658,8 @@ int32_t lsm6dso32_ff_dur_get(const stmdev_ctx_t *ctx, uint8_t *val)
   *
   */
 
+#endif /* LSM6DSO32_FEATURE_TAP */
+
 /**
   * @defgroup  LSM6DSO32_fifo
   * @brief   This section group all the functions concerning the fifo usage
@@ -6515,30 +8198,655 @@ int32_t lsm6dso32_sh_batch_slave_3_get(const stmdev_ctx_t *ctx,
 }
 
 /**
-  * @}
-  *
-  */
-
-/**
-  * @defgroup  LSM6DSO32_DEN_functionality
-  * @brief     This section groups all the functions concerning
-  *            DEN functionality.
-  * @{
-  *
-  */
-
-/**
-  * @brief  DEN functionality marking mode.[set]
+  * @brief  Reset the FIFO stream decoder state.[set]
   *
-  * @param  ctx      read / write interface definitions
-  * @param  val      change the values of den_mode in reg CTRL6_C
-  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  * @param  stream   FIFO stream decoder state
   *
   */
-int32_t lsm6dso32_den_mode_set(const stmdev_ctx_t *ctx,
-                               lsm6dso32_den_mode_t val)
+void lsm6dso32_fifo_stream_init(lsm6dso32_fifo_stream_t *stream)
 {
-  lsm6dso32_ctrl6_c_t reg;
+  uint8_t i;
+
+  stream->timestamp = 0U;
+  stream->ts_valid = PROPERTY_DISABLE;
+  stream->words = 0U;
+
+  for (i = 0U; i < 4U; i++)
+  {
+    stream->slave[i] = 0U;
+    stream->nack[i] = 0U;
+  }
+}
+
+/* record from an unpacked FIFO word: TAG byte and X, Y, Z */
+static void lsm6dso32_fifo_record_fill(lsm6dso32_fifo_stream_t *stream,
+                                       uint8_t tag, const int16_t *data,
+                                       lsm6dso32_fifo_record_t *rec)
+{
+  lsm6dso32_reg_t reg;
+  uint32_t timestamp;
+  uint8_t i;
+
+  reg.byte = tag;
+  rec->tag = (lsm6dso32_fifo_tag_t)reg.fifo_data_out_tag.tag_sensor;
+  rec->cnt = reg.fifo_data_out_tag.tag_cnt;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    rec->data[i] = data[i];
+    rec->raw[2U * i] = (uint8_t)((uint16_t)data[i] & 0xFFU);
+    rec->raw[(2U * i) + 1U] = (uint8_t)((uint16_t)data[i] >> 8);
+  }
+
+  switch (rec->tag)
+  {
+    case LSM6DSO32_TIMESTAMP_TAG:
+      timestamp = (uint16_t)data[1];
+      timestamp = (timestamp * 65536U) + (uint16_t)data[0];
+      stream->timestamp = timestamp;
+      stream->ts_valid = PROPERTY_ENABLE;
+      break;
+
+    case LSM6DSO32_SENSORHUB_SLAVE0_TAG:
+    case LSM6DSO32_SENSORHUB_SLAVE1_TAG:
+    case LSM6DSO32_SENSORHUB_SLAVE2_TAG:
+    case LSM6DSO32_SENSORHUB_SLAVE3_TAG:
+      stream->slave[(uint8_t)rec->tag -
+                    (uint8_t)LSM6DSO32_SENSORHUB_SLAVE0_TAG]++;
+      break;
+
+    case LSM6DSO32_SENSORHUB_NACK_TAG:
+      /* first byte: index of the slave which did not acknowledge */
+      stream->nack[rec->raw[0] & 0x03U]++;
+      break;
+
+    default:
+      break;
+  }
+
+  rec->timestamp = stream->timestamp;
+  stream->words++;
+}
+
+/**
+  * @brief  Decode one FIFO word (TAG + 6 bytes).[get]
+  *
+  *         Every record is stamped with the last TIMESTAMP_TAG value,
+  *         so sensor hub slave samples line up with the IMU samples
+  *         batched at the same time. Sensor hub NACK words are counted
+  *         per slave in the stream state.
+  *
+  * @param  stream   FIFO stream decoder state
+  * @param  word     7 bytes read from FIFO_DATA_OUT_TAG
+  * @param  rec      decoded record
+  *
+  */
+void lsm6dso32_fifo_record_decode(lsm6dso32_fifo_stream_t *stream,
+                                  const uint8_t *word,
+                                  lsm6dso32_fifo_record_t *rec)
+{
+  int16_t data[3];
+  uint8_t tag;
+
+  lsm6dso32_fifo_words_unpack(word, 1U, &tag, data);
+  lsm6dso32_fifo_record_fill(stream, word[0], data, rec);
+}
+
+/**
+  * @brief  Unpack contiguous FIFO words (TAG + 6 bytes) read in a single
+  *         burst into sensor tags and int16 triplets.[get]
+  *
+  *         On little-endian hosts with SSSE3 (x86) or NEON (AArch64) two
+  *         words are shuffled per 16-byte load; a 16-byte load is issued
+  *         only when at least three words are left, so the input buffer
+  *         is never over-read. The portable path is used otherwise and
+  *         for the remaining words.
+  *
+  * @param  buff     FIFO words, 7 * num bytes
+  * @param  num      number of FIFO words
+  * @param  tag      TAG_SENSOR of each word (lsm6dso32_fifo_tag_t)
+  * @param  data     X, Y, Z of each word, 3 * num values
+  *
+  */
+void lsm6dso32_fifo_words_unpack(const uint8_t *buff, uint16_t num,
+                                 uint8_t *tag, int16_t *data)
+{
+  uint16_t i = 0U;
+  uint8_t k;
+
+#if (DRV_BYTE_ORDER == DRV_LITTLE_ENDIAN) && defined(__SSSE3__)
+  const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 4, 5, 6,
+                                        8, 9, 10, 11, 12, 13,
+                                        -1, -1, -1, -1);
+  __m128i word;
+
+  /* 16 bytes stored: the 4 spare bytes land on the next word output */
+  while ((uint16_t)(num - i) >= 3U)
+  {
+    word = _mm_loadu_si128((const __m128i *)&buff[7U * i]);
+    _mm_storeu_si128((__m128i *)&data[3U * i],
+                     _mm_shuffle_epi8(word, shuffle));
+    tag[i] = buff[7U * i] >> 3;
+    tag[i + 1U] = buff[(7U * i) + 7U] >> 3;
+    i += 2U;
+  }
+#elif (DRV_BYTE_ORDER == DRV_LITTLE_ENDIAN) && defined(__aarch64__) && \
+      defined(__ARM_NEON)
+  static const uint8_t shuffle_tbl[16] = { 1U, 2U, 3U, 4U, 5U, 6U,
+                                           8U, 9U, 10U, 11U, 12U, 13U,
+                                           0xFFU, 0xFFU, 0xFFU, 0xFFU
+                                         };
+  const uint8x16_t shuffle = vld1q_u8(shuffle_tbl);
+  uint8x16_t word;
+
+  /* 16 bytes stored: the 4 spare bytes land on the next word output */
+  while ((uint16_t)(num - i) >= 3U)
+  {
+    word = vld1q_u8(&buff[7U * i]);
+    vst1q_u8((uint8_t *)&data[3U * i], vqtbl1q_u8(word, shuffle));
+    tag[i] = buff[7U * i] >> 3;
+    tag[i + 1U] = buff[(7U * i) + 7U] >> 3;
+    i += 2U;
+  }
+#endif /* SIMD FIFO unpack */
+
+  for (; i < num; i++)
+  {
+    tag[i] = buff[7U * i] >> 3;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      data[(3U * i) + k] = (int16_t)buff[(7U * i) + (2U * k) + 2U];
+      data[(3U * i) + k] = (data[(3U * i) + k] * 256) +
+                           (int16_t)buff[(7U * i) + (2U * k) + 1U];
+    }
+  }
+}
+
+/**
+  * @brief  Read and decode the FIFO content.[get]
+  *
+  *         FIFO words are read in bursts of up to
+  *         LSM6DSO32_FIFO_BURST_WORDS (the address rolls back from
+  *         FIFO_DATA_OUT_Z_H to FIFO_DATA_OUT_TAG, register
+  *         auto-increment must be enabled) and unpacked with
+  *         lsm6dso32_fifo_words_unpack.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  stream   FIFO stream decoder state
+  * @param  rec      records buffer
+  * @param  len      records buffer length
+  * @param  num      number of records decoded
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_fifo_stream_read(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_fifo_stream_t *stream,
+                                   lsm6dso32_fifo_record_t *rec,
+                                   uint16_t len, uint16_t *num)
+{
+  uint8_t buff[7U * LSM6DSO32_FIFO_BURST_WORDS];
+  uint8_t tag[LSM6DSO32_FIFO_BURST_WORDS];
+  int16_t data[3U * LSM6DSO32_FIFO_BURST_WORDS];
+  uint16_t level;
+  uint16_t burst;
+  uint16_t i;
+  int32_t ret;
+
+  *num = 0U;
+  ret = lsm6dso32_fifo_data_level_get(ctx, &level);
+
+  if ((ret == 0) && (level > len))
+  {
+    level = len;
+  }
+
+  while ((ret == 0) && (*num < level))
+  {
+    burst = (uint16_t)(level - *num);
+    burst = (burst > LSM6DSO32_FIFO_BURST_WORDS) ?
+            LSM6DSO32_FIFO_BURST_WORDS : burst;
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FIFO_DATA_OUT_TAG, buff,
+                             (uint16_t)(7U * burst));
+
+    if (ret == 0)
+    {
+      lsm6dso32_fifo_words_unpack(buff, burst, tag, data);
+
+      for (i = 0U; i < burst; i++)
+      {
+        lsm6dso32_fifo_record_fill(stream, buff[7U * i], &data[3U * i],
+                                   &rec[*num + i]);
+      }
+
+      *num += burst;
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Initialize the gyroscope temperature compensation stage.[set]
+  *
+  * @param  comp     compensation stage state
+  * @param  coef     per-device coefficients (see lsm6dso32_gy_tcomp_fit_solve)
+  *
+  */
+void lsm6dso32_gy_tcomp_init(lsm6dso32_gy_tcomp_t *comp,
+                             const lsm6dso32_gy_tcomp_coef_t *coef)
+{
+  comp->coef = *coef;
+  comp->temp = coef->t0;
+  comp->since = 0U;
+  comp->temp_valid = PROPERTY_DISABLE;
+}
+
+/**
+  * @brief  Apply gyroscope temperature compensation to decoded FIFO
+  *         records (in place).[set]
+  *
+  *         The temperature of each gyroscope record is linearly
+  *         interpolated (by FIFO position) between the surrounding
+  *         TEMPERATURE_TAG records, the last one of the previous batch
+  *         included; after the last temperature of the batch it is held.
+  *         out = (raw - bias - bias_tc * dT) / (1 + sens_tc * dT)
+  *         GYRO_NC, GYRO_NC_T_1 and GYRO_NC_T_2 records are compensated.
+  *         Compressed GYRO_2XC / GYRO_3XC records hold differences that
+  *         lsm6dso32_fifo_record_decode does not expand and are left
+  *         untouched. Until the first temperature sample of the stream,
+  *         records are compensated with the next TEMPERATURE_TAG of the
+  *         batch, or left untouched when the batch has none.
+  *
+  * @param  comp     compensation stage state
+  * @param  rec      records decoded by lsm6dso32_fifo_stream_read
+  * @param  num      number of records
+  *
+  */
+void lsm6dso32_gy_tcomp_apply(lsm6dso32_gy_tcomp_t *comp,
+                              lsm6dso32_fifo_record_t *rec, uint16_t num)
+{
+  float_t temp_next = 0.0f;
+  float_t temp;
+  float_t dt;
+  float_t val;
+  uint16_t next = 0U;
+  uint16_t i;
+  uint8_t k;
+
+  for (i = 0U; i < num; i++)
+  {
+    /* look for the next temperature record of the batch */
+    if (next <= i)
+    {
+      next = i;
+
+      while ((next < num) && (rec[next].tag != LSM6DSO32_TEMPERATURE_TAG))
+      {
+        next++;
+      }
+
+      if (next < num)
+      {
+        temp_next = lsm6dso32_from_lsb_to_celsius(rec[next].data[0]);
+      }
+    }
+
+    if (rec[i].tag == LSM6DSO32_TEMPERATURE_TAG)
+    {
+      comp->temp = temp_next;
+      comp->since = 0U;
+      comp->temp_valid = PROPERTY_ENABLE;
+    }
+
+    else
+    {
+      if (comp->since < 0xFFFFU)
+      {
+        comp->since++;
+      }
+
+      if (((rec[i].tag == LSM6DSO32_GYRO_NC_TAG) ||
+           (rec[i].tag == LSM6DSO32_GYRO_NC_T_1_TAG) ||
+           (rec[i].tag == LSM6DSO32_GYRO_NC_T_2_TAG)) &&
+          ((comp->temp_valid == PROPERTY_ENABLE) || (next < num)))
+      {
+        if (comp->temp_valid == PROPERTY_DISABLE)
+        {
+          temp = temp_next;
+        }
+
+        else if (next < num)
+        {
+          temp = comp->temp + ((temp_next - comp->temp) *
+                               (float_t)comp->since /
+                               (float_t)(comp->since + (next - i)));
+        }
+
+        else
+        {
+          temp = comp->temp;
+        }
+
+        dt = temp - comp->coef.t0;
+
+        for (k = 0U; k < 3U; k++)
+        {
+          val = (float_t)rec[i].data[k] - comp->coef.bias[k] -
+                (comp->coef.bias_tc[k] * dt);
+          val = val / (1.0f + (comp->coef.sens_tc[k] * dt));
+          val = (val > 32767.0f) ? 32767.0f : val;
+          val = (val < -32768.0f) ? -32768.0f : val;
+          rec[i].data[k] = (int16_t)((val < 0.0f) ? (val - 0.5f) : (val + 0.5f));
+        }
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Reset the gyroscope temperature coefficients fit.[set]
+  *
+  * @param  fit      least squares accumulator
+  * @param  t0       reference temperature [degC]
+  *
+  */
+void lsm6dso32_gy_tcomp_fit_init(lsm6dso32_gy_tcomp_fit_t *fit, float_t t0)
+{
+  uint8_t k;
+
+  fit->n = 0U;
+  fit->st = 0.0;
+  fit->stt = 0.0;
+  fit->t0 = t0;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    fit->sy[k] = 0.0;
+    fit->sty[k] = 0.0;
+  }
+}
+
+/**
+  * @brief  Add a still gyroscope sample of a thermal sweep to the
+  *         fit.[set]
+  *
+  * @param  fit      least squares accumulator
+  * @param  temp     sample temperature [degC]
+  * @param  gy       gyroscope raw output [LSB]
+  *
+  */
+void lsm6dso32_gy_tcomp_fit_add(lsm6dso32_gy_tcomp_fit_t *fit,
+                                float_t temp, const int16_t *gy)
+{
+  double_t dt = (double_t)temp - (double_t)fit->t0;
+  uint8_t k;
+
+  fit->n++;
+  fit->st += dt;
+  fit->stt += dt * dt;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    fit->sy[k] += (double_t)gy[k];
+    fit->sty[k] += dt * (double_t)gy[k];
+  }
+}
+
+/**
+  * @brief  Solve the bias / bias drift least squares fit.[get]
+  *
+  *         Sensitivity drift cannot be observed on a still device and
+  *         coef->sens_tc is left unchanged.
+  *
+  * @param  fit      least squares accumulator
+  * @param  coef     fitted coefficients
+  * @retval             0 -> fit done, -1 -> temperature range too narrow
+  *
+  */
+int32_t lsm6dso32_gy_tcomp_fit_solve(const lsm6dso32_gy_tcomp_fit_t *fit,
+                                     lsm6dso32_gy_tcomp_coef_t *coef)
+{
+  double_t det;
+  double_t tc;
+  double_t n;
+  uint8_t k;
+  int32_t ret = 0;
+
+  n = (double_t)fit->n;
+  det = (n * fit->stt) - (fit->st * fit->st);
+
+  /* temperature standard deviation of at least 0.1 degC */
+  if ((fit->n < 2U) || (det <= (n * n * 0.01)))
+  {
+    ret = -1;
+  }
+
+  else
+  {
+    coef->t0 = fit->t0;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      tc = ((n * fit->sty[k]) - (fit->st * fit->sy[k])) / det;
+      coef->bias_tc[k] = (float_t)tc;
+      coef->bias[k] = (float_t)((fit->sy[k] - (tc * fit->st)) / n);
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Initialize a single-producer / multi-consumer record
+  *         ring.[set]
+  *
+  *         The ring holds no pointers and can be placed in memory shared
+  *         between processes (the mapping is left to the application).
+  *         Each consumer keeps its own read cursor; there is no
+  *         producer-side per-consumer state.
+  *
+  * @param  ring     record ring
+  *
+  */
+void lsm6dso32_ring_init(lsm6dso32_ring_t *ring)
+{
+  ring->reserved = 0U;
+  ring->head = 0U;
+}
+
+/**
+  * @brief  Publish records in the ring (single producer).[set]
+  *
+  * @param  ring     record ring
+  * @param  rec      records to publish
+  * @param  num      number of records
+  *
+  */
+void lsm6dso32_ring_publish(lsm6dso32_ring_t *ring,
+                            const lsm6dso32_fifo_record_t *rec,
+                            uint16_t num)
+{
+  uint32_t head = ring->head;
+  uint16_t i;
+
+  /* announce the slots about to be overwritten */
+  ring->reserved = head + num;
+  LSM6DSO32_MEM_BARRIER();
+
+  for (i = 0U; i < num; i++)
+  {
+    ring->rec[(head + i) & (LSM6DSO32_RING_LEN - 1U)] = rec[i];
+  }
+
+  LSM6DSO32_MEM_BARRIER();
+  ring->head = head + num;
+}
+
+/**
+  * @brief  Drain the FIFO and publish the decoded records.[get]
+  *
+  *         Up to LSM6DSO32_RING_FIFO_BATCH ring slots are reserved per
+  *         FIFO level read. The words are read in bursts of up to
+  *         LSM6DSO32_FIFO_BURST_WORDS, unpacked with
+  *         lsm6dso32_fifo_words_unpack and decoded straight into their
+  *         slots: the stack holds one burst, not the batch.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  stream   FIFO stream decoder state
+  * @param  ring     record ring
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_ring_publish_fifo(const stmdev_ctx_t *ctx,
+                                    lsm6dso32_fifo_stream_t *stream,
+                                    lsm6dso32_ring_t *ring)
+{
+  uint8_t buff[7U * LSM6DSO32_FIFO_BURST_WORDS];
+  uint8_t tag[LSM6DSO32_FIFO_BURST_WORDS];
+  int16_t data[3U * LSM6DSO32_FIFO_BURST_WORDS];
+  uint32_t head;
+  uint16_t num = LSM6DSO32_RING_FIFO_BATCH;
+  uint16_t burst;
+  uint16_t n;
+  uint16_t i;
+  int32_t ret = 0;
+
+  while ((ret == 0) && (num == LSM6DSO32_RING_FIFO_BATCH))
+  {
+    ret = lsm6dso32_fifo_data_level_get(ctx, &num);
+    num = (num > LSM6DSO32_RING_FIFO_BATCH) ? LSM6DSO32_RING_FIFO_BATCH : num;
+    num = (ret == 0) ? num : 0U;
+    head = ring->head;
+
+    /* announce the slots about to be overwritten */
+    ring->reserved = head + num;
+    LSM6DSO32_MEM_BARRIER();
+
+    n = 0U;
+
+    /* only the decoded records are published */
+    while ((ret == 0) && (n < num))
+    {
+      burst = (uint16_t)(num - n);
+      burst = (burst > LSM6DSO32_FIFO_BURST_WORDS) ?
+              LSM6DSO32_FIFO_BURST_WORDS : burst;
+      ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FIFO_DATA_OUT_TAG, buff,
+                               (uint16_t)(7U * burst));
+
+      if (ret == 0)
+      {
+        lsm6dso32_fifo_words_unpack(buff, burst, tag, data);
+
+        for (i = 0U; i < burst; i++)
+        {
+          lsm6dso32_fifo_record_fill(stream, buff[7U * i], &data[3U * i],
+                                     &ring->rec[(head + n + i) &
+                                                (LSM6DSO32_RING_LEN - 1U)]);
+        }
+
+        n += burst;
+      }
+    }
+
+    LSM6DSO32_MEM_BARRIER();
+    ring->head = head + n;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Read records from the ring (any number of consumers).[get]
+  *
+  *         Records overwritten before (or while) being copied are
+  *         skipped and counted as lost; the cursor is moved forward.
+  *
+  * @param  ring     record ring
+  * @param  cursor   consumer read cursor (0 or ring->head to start)
+  * @param  rec      records buffer
+  * @param  len      records buffer length
+  * @param  lost     incremented by the number of records lost
+  * @retval             number of records returned
+  *
+  */
+uint16_t lsm6dso32_ring_read(const lsm6dso32_ring_t *ring, uint32_t *cursor,
+                             lsm6dso32_fifo_record_t *rec, uint16_t len,
+                             uint32_t *lost)
+{
+  uint32_t head = ring->head;
+  uint32_t pos = *cursor;
+  uint32_t avail;
+  uint16_t num = 0U;
+  uint16_t i;
+  uint16_t j;
+
+  LSM6DSO32_MEM_BARRIER();
+
+  if ((head - pos) > LSM6DSO32_RING_LEN)
+  {
+    *lost += (head - pos) - LSM6DSO32_RING_LEN;
+    pos = head - LSM6DSO32_RING_LEN;
+  }
+
+  avail = head - pos;
+  num = (avail < len) ? (uint16_t)avail : len;
+
+  for (i = 0U; i < num; i++)
+  {
+    rec[i] = ring->rec[(pos + i) & (LSM6DSO32_RING_LEN - 1U)];
+  }
+
+  /* drop the records the producer started overwriting meanwhile */
+  LSM6DSO32_MEM_BARRIER();
+  avail = ring->reserved - pos;
+
+  if (avail > LSM6DSO32_RING_LEN)
+  {
+    i = ((avail - LSM6DSO32_RING_LEN) < num) ?
+        (uint16_t)(avail - LSM6DSO32_RING_LEN) : num;
+    *lost += i;
+    pos += i;
+    num -= i;
+
+    for (j = 0U; j < num; j++)
+    {
+      rec[j] = rec[j + i];
+    }
+  }
+
+  *cursor = pos + num;
+
+  return num;
+}
+
+/**
+  * @}
+  *
+  */
+
+#if LSM6DSO32_FEATURE_DEN
+
+/**
+  * @defgroup  LSM6DSO32_DEN_functionality
+  * @brief     This section groups all the functions concerning
+  *            DEN functionality.
+  * @{
+  *
+  */
+
+/**
+  * @brief  DEN functionality marking mode.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      change the values of den_mode in reg CTRL6_C
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_den_mode_set(const stmdev_ctx_t *ctx,
+                               lsm6dso32_den_mode_t val)
+{
+  lsm6dso32_ctrl6_c_t reg;
   int32_t ret;
 
   ret = lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL6_C, (uint8_t *)&reg, 1);
@@ -6850,9 +9158,128 @@ int32_t lsm6dso32_den_mark_axis_z_get(const stmdev_ctx_t *ctx, uint8_t *val)
 }
 
 /**
-  * @}
+  * @brief  Initialize the DEN stamp decoder from CTRL9_XL.[get]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  dec      DEN decoder state
+  * @param  policy   data LSB handling after the stamp is extracted
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
   *
   */
+int32_t lsm6dso32_den_decoder_init(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_den_decoder_t *dec,
+                                   lsm6dso32_den_lsb_t policy)
+{
+  lsm6dso32_ctrl9_xl_t reg;
+  int32_t ret;
+
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL9_XL, (uint8_t *)&reg, 1);
+
+  if (ret == 0)
+  {
+    /* same axis mapping as lsm6dso32_den_mark_axis_x/y/z_set */
+    dec->axis = (uint8_t)(reg.den_z | (reg.den_y << 1) | (reg.den_x << 2));
+
+    switch (reg.den_xl_g)
+    {
+      case LSM6DSO32_STAMP_IN_XL_DATA:
+        dec->xl_g = LSM6DSO32_STAMP_IN_XL_DATA;
+        break;
+
+      case LSM6DSO32_STAMP_IN_GY_XL_DATA:
+        dec->xl_g = LSM6DSO32_STAMP_IN_GY_XL_DATA;
+        break;
+
+      default:
+        dec->xl_g = LSM6DSO32_STAMP_IN_GY_DATA;
+        break;
+    }
+
+    dec->policy = policy;
+    dec->level = PROPERTY_DISABLE;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Extract the DEN stamp from a FIFO record.[get]
+  *
+  *         Only non-compressed samples of the stamped sensor are
+  *         considered; the stamp is read from the first stamped axis
+  *         and the data LSB of the stamped axes is handled according to
+  *         the decoder policy.
+  *
+  * @param  dec      DEN decoder state
+  * @param  rec      FIFO record (see lsm6dso32_fifo_record_decode)
+  * @param  edge     DEN edge, valid when 1 is returned
+  * @retval             1 -> DEN level changed on this sample, 0 -> no edge
+  *
+  */
+uint8_t lsm6dso32_den_decode(lsm6dso32_den_decoder_t *dec,
+                             lsm6dso32_fifo_record_t *rec,
+                             lsm6dso32_den_edge_t *edge)
+{
+  uint8_t stamped = PROPERTY_DISABLE;
+  uint8_t level = 0xFFU;
+  uint8_t ret = 0U;
+  uint8_t i;
+
+  switch (rec->tag)
+  {
+    case LSM6DSO32_XL_NC_TAG:
+    case LSM6DSO32_XL_NC_T_1_TAG:
+    case LSM6DSO32_XL_NC_T_2_TAG:
+      stamped = (dec->xl_g != LSM6DSO32_STAMP_IN_GY_DATA) ?
+                PROPERTY_ENABLE : PROPERTY_DISABLE;
+      break;
+
+    case LSM6DSO32_GYRO_NC_TAG:
+    case LSM6DSO32_GYRO_NC_T_1_TAG:
+    case LSM6DSO32_GYRO_NC_T_2_TAG:
+      stamped = (dec->xl_g != LSM6DSO32_STAMP_IN_XL_DATA) ?
+                PROPERTY_ENABLE : PROPERTY_DISABLE;
+      break;
+
+    default:
+      break;
+  }
+
+  for (i = 0U; (stamped == PROPERTY_ENABLE) && (i < 3U); i++)
+  {
+    if ((dec->axis & (1U << i)) != 0U)
+    {
+      if (level == 0xFFU)
+      {
+        level = (uint8_t)((uint16_t)rec->data[i] & 0x0001U);
+      }
+
+      if (dec->policy == LSM6DSO32_DEN_LSB_CLEAR)
+      {
+        rec->data[i] = (int16_t)((uint16_t)rec->data[i] & 0xFFFEU);
+      }
+    }
+  }
+
+  if ((level != 0xFFU) && (level != dec->level))
+  {
+    dec->level = level;
+    edge->level = level;
+    edge->timestamp = rec->timestamp;
+    ret = 1U;
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+#endif /* LSM6DSO32_FEATURE_DEN */
+
+#if LSM6DSO32_FEATURE_PEDO
 
 /**
   * @defgroup  LSM6DSO32_Pedometer
@@ -7414,6 +9841,10 @@ int32_t lsm6dso32_tilt_flag_data_ready_get(const stmdev_ctx_t *ctx,
   *
   */
 
+#endif /* LSM6DSO32_FEATURE_PEDO */
+
+#if LSM6DSO32_FEATURE_MAG
+
 /**
   * @defgroup  LSM6DSO32_ magnetometer_sensor
   * @brief     This section groups all the functions that manage additional
@@ -7463,13 +9894,10 @@ int32_t lsm6dso32_mag_sensitivity_get(const stmdev_ctx_t *ctx,
   uint8_t buff[2];
   int32_t ret;
 
-  ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SENSITIVITY_L,
-                                  &buff[0]);
+  ret = lsm6dso32_ln_pg_read(ctx, LSM6DSO32_MAG_SENSITIVITY_L, buff, 2);
 
   if (ret == 0)
   {
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SENSITIVITY_H,
-                                    &buff[1]);
     *val = buff[1];
     *val = (*val * 256U) +  buff[0];
   }
@@ -7545,37 +9973,10 @@ int32_t lsm6dso32_mag_offset_get(const stmdev_ctx_t *ctx, int16_t *val)
   uint8_t buff[6];
   int32_t ret;
 
-  ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_OFFX_L,
-                                  &buff[0]);
-
-  if (ret == 0)
-  {
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_OFFX_H,
-                                    &buff[1]);
-  }
-
-  if (ret == 0)
-  {
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_OFFY_L,
-                                    &buff[2]);
-  }
-
-  if (ret == 0)
-  {
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_OFFY_H,
-                                    &buff[3]);
-  }
-
-  if (ret == 0)
-  {
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_OFFZ_L,
-                                    &buff[4]);
-  }
+  ret = lsm6dso32_ln_pg_read(ctx, LSM6DSO32_MAG_OFFX_L, buff, 6);
 
   if (ret == 0)
   {
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_OFFZ_H,
-                                    &buff[5]);
     val[0] = (int16_t)buff[1];
     val[0] = (val[0] * 256) + (int16_t)buff[0];
     val[1] = (int16_t)buff[3];
@@ -7723,101 +10124,24 @@ int32_t lsm6dso32_mag_soft_iron_get(const stmdev_ctx_t *ctx, int16_t *val)
   uint8_t buff[12];
   int32_t ret;
 
-  uint8_t index;
-  index = 0x00U;
-  ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_XX_L,
-                                  &buff[index]);
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_XX_H,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_XY_L,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_XY_H,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_XZ_L,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_XZ_H,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_YY_L,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_YY_H,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_YZ_L,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_YZ_H,
-                                    &buff[index]);
-  }
-
-  if (ret == 0)
-  {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_ZZ_L,
-                                    &buff[index]);
-  }
+  ret = lsm6dso32_ln_pg_read(ctx, LSM6DSO32_MAG_SI_XX_L, buff, 12);
 
   if (ret == 0)
   {
-    index++;
-    ret = lsm6dso32_ln_pg_read_byte(ctx, LSM6DSO32_MAG_SI_ZZ_H,
-                                    &buff[index]);
+    val[0] = (int16_t)buff[1];
+    val[0] = (val[0] * 256) + (int16_t)buff[0];
+    val[1] = (int16_t)buff[3];
+    val[1] = (val[1] * 256) + (int16_t)buff[2];
+    val[2] = (int16_t)buff[5];
+    val[2] = (val[2] * 256) + (int16_t)buff[4];
+    val[3] = (int16_t)buff[7];
+    val[3] = (val[3] * 256) + (int16_t)buff[6];
+    val[4] = (int16_t)buff[9];
+    val[4] = (val[4] * 256) + (int16_t)buff[8];
+    val[5] = (int16_t)buff[11];
+    val[5] = (val[5] * 256) + (int16_t)buff[10];
   }
 
-  val[0] = (int16_t)buff[1];
-  val[0] = (val[0] * 256) + (int16_t)buff[0];
-  val[1] = (int16_t)buff[3];
-  val[1] = (val[1] * 256) + (int16_t)buff[2];
-  val[2] = (int16_t)buff[5];
-  val[2] = (val[2] * 256) + (int16_t)buff[4];
-  val[3] = (int16_t)buff[7];
-  val[3] = (val[3] * 256) + (int16_t)buff[6];
-  val[4] = (int16_t)buff[9];
-  val[4] = (val[4] * 256) + (int16_t)buff[8];
-  val[5] = (int16_t)buff[11];
-  val[5] = (val[5] * 256) + (int16_t)buff[10];
-
   return ret;
 }
 
@@ -8078,6 +10402,10 @@ int32_t lsm6dso32_mag_x_orient_get(const stmdev_ctx_t *ctx,
   *
   */
 
+#endif /* LSM6DSO32_FEATURE_MAG */
+
+#if LSM6DSO32_FEATURE_FSM
+
 /**
   * @defgroup  LSM6DSO32_finite_state_machine
   * @brief     This section groups all the functions that manage the
@@ -8463,7 +10791,7 @@ int32_t lsm6dso32_fsm_out_get(const stmdev_ctx_t *ctx,
 
   if (ret == 0)
   {
-    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_OUTS1, (uint8_t *) &val,
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_OUTS1, (uint8_t *) val,
                              16);
   }
 
@@ -8475,6 +10803,174 @@ int32_t lsm6dso32_fsm_out_get(const stmdev_ctx_t *ctx,
   return ret;
 }
 
+/**
+  * @brief  FSM status, long counter and outputs snapshot.[get]
+  *
+  *         One embedded functions bank session with two bursts:
+  *         EMB_FUNC_STATUS to FSM_STATUS_B and FSM_LONG_COUNTER_L
+  *         to FSM_OUTS16.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      FSM snapshot
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_fsm_snapshot_get(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_fsm_snapshot_t *val)
+{
+  uint8_t *fsm_out = (uint8_t *)&val->fsm_out;
+  uint8_t buff[20];
+  uint8_t i;
+  int32_t ret;
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_EMBEDDED_FUNC_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_EMB_FUNC_STATUS,
+                             (uint8_t *)&val->emb_func_status, 3);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_FSM_LONG_COUNTER_L, buff, 20);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+    val->long_counter = buff[1];
+    val->long_counter = (val->long_counter * 256U) +  buff[0];
+
+    for (i = 0U; i < 16U; i++)
+    {
+      fsm_out[i] = buff[(LSM6DSO32_FSM_OUTS1 -
+                         LSM6DSO32_FSM_LONG_COUNTER_L) + i];
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Reset the FSM event log.[set]
+  *
+  * @param  log      FSM event log
+  *
+  */
+void lsm6dso32_fsm_log_init(lsm6dso32_fsm_log_t *log)
+{
+  uint8_t i;
+
+  log->head = 0U;
+  log->tail = 0U;
+  log->dropped = 0U;
+
+  for (i = 0U; i < 16U; i++)
+  {
+    log->count[i] = 0U;
+  }
+}
+
+/**
+  * @brief  Capture FSM status, long counter, outputs and device
+  *         timestamp and append them to the event log.[get]
+  *
+  *         Intended to be called on the FSM interrupt (single producer);
+  *         nothing is appended if no FSM status bit is set.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  log      FSM event log
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_fsm_log_capture(const stmdev_ctx_t *ctx,
+                                  lsm6dso32_fsm_log_t *log)
+{
+  lsm6dso32_fsm_snapshot_t snap;
+  lsm6dso32_fsm_event_t *event;
+  uint32_t timestamp;
+  uint16_t status;
+  uint16_t head;
+  uint8_t i;
+  int32_t ret;
+
+  ret = lsm6dso32_fsm_snapshot_get(ctx, &snap);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_timestamp_raw_get(ctx, &timestamp);
+  }
+
+  if (ret == 0)
+  {
+    status = *(uint8_t *)&snap.fsm_status_b;
+    status = (status * 256U) + *(uint8_t *)&snap.fsm_status_a;
+
+    for (i = 0U; i < 16U; i++)
+    {
+      if ((status & (1U << i)) != 0U)
+      {
+        log->count[i]++;
+      }
+    }
+
+    head = log->head;
+
+    if (status == 0U)
+    {
+      /* no FSM event */
+    }
+
+    else if ((uint16_t)(head - log->tail) >= LSM6DSO32_FSM_LOG_LEN)
+    {
+      log->dropped++;
+    }
+
+    else
+    {
+      event = &log->event[head & (LSM6DSO32_FSM_LOG_LEN - 1U)];
+      event->timestamp = timestamp;
+      event->status = status;
+      event->long_counter = snap.long_counter;
+      event->fsm_out = snap.fsm_out;
+      /* publish the event only once completely written */
+      LSM6DSO32_MEM_BARRIER();
+      log->head = head + 1U;
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Remove the oldest event from the FSM event log
+  *         (single consumer).[get]
+  *
+  * @param  log      FSM event log
+  * @param  val      oldest event, valid when 1 is returned
+  * @retval             1 -> event returned, 0 -> log empty
+  *
+  */
+uint8_t lsm6dso32_fsm_log_pop(lsm6dso32_fsm_log_t *log,
+                              lsm6dso32_fsm_event_t *val)
+{
+  uint16_t tail = log->tail;
+  uint8_t ret = 0U;
+
+  if (tail != log->head)
+  {
+    LSM6DSO32_MEM_BARRIER();
+    *val = log->event[tail & (LSM6DSO32_FSM_LOG_LEN - 1U)];
+    /* release the slot only once completely read */
+    LSM6DSO32_MEM_BARRIER();
+    log->tail = tail + 1U;
+    ret = 1U;
+  }
+
+  return ret;
+}
+
 /**
   * @brief  Finite State Machine ODR configuration.[set]
   *
@@ -8795,6 +11291,10 @@ int32_t lsm6dso32_fsm_start_address_get(const stmdev_ctx_t *ctx,
   *
   */
 
+#endif /* LSM6DSO32_FEATURE_FSM */
+
+#if LSM6DSO32_FEATURE_SH
+
 /**
   * @defgroup  LSM6DSO32_Sensor_hub
   * @brief     This section groups all the functions that manage the
@@ -9759,9 +12259,1871 @@ int32_t lsm6dso32_sh_status_get(const stmdev_ctx_t *ctx,
 }
 
 /**
-  * @}
+  * @brief  Prepare a sequence of external device transactions executed
+  *         through sensor hub slave 0.[set]
+  *
+  *         Read transactions are 1 to 7 bytes long and are completed in
+  *         one sensor hub cycle; write transactions are split into one
+  *         byte per sensor hub cycle (auto-incremented subaddress).
+  *         Sensor hub master and trigger must be already configured.
+  *
+  * @param  seq      sequencer state
+  * @param  xfer     array of transactions (owned by the caller)
+  * @param  num      number of transactions
+  * @retval             0 -> sequence accepted, -1 -> invalid transaction
   *
   */
+int32_t lsm6dso32_sh_seq_init(lsm6dso32_sh_seq_t *seq,
+                              lsm6dso32_sh_xfer_t *xfer, uint8_t num)
+{
+  int32_t ret = 0;
+  uint8_t i;
+
+  if ((seq == NULL) || ((xfer == NULL) && (num > 0U)))
+  {
+    ret = -1;
+  }
+
+  for (i = 0U; (ret == 0) && (i < num); i++)
+  {
+    if ((xfer[i].data == NULL) || (xfer[i].len == 0U) ||
+        ((xfer[i].rd != PROPERTY_DISABLE) && (xfer[i].len > 7U)))
+    {
+      ret = -1;
+    }
+
+    else
+    {
+      xfer[i].status = LSM6DSO32_SH_XFER_PENDING;
+    }
+  }
+
+  if (ret == 0)
+  {
+    seq->xfer = xfer;
+    seq->num = num;
+    seq->idx = 0U;
+    seq->ofs = 0U;
+    seq->ext_trig = PROPERTY_DISABLE;
+    seq->xl_drdy = PROPERTY_DISABLE;
+    seq->state = LSM6DSO32_SH_SEQ_IDLE;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Advance the sensor hub transaction sequence.[set]
+  *
+  *         Non-blocking: it can be called by polling or from the
+  *         sensor hub end of operation interrupt. Completion is detected
+  *         on the user bank (STATUS_REG / STATUS_MASTER_MAINPAGE); the
+  *         sensor hub bank is entered once per completed transaction to
+  *         collect the read data and program the next transaction.
+  *         The trigger (lsm6dso32_sh_syncro_mode_set) is read when the
+  *         first transaction is programmed:
+  *         - LSM6DSO32_XL_GY_DRDY: the accelerometer must be running.
+  *           A cycle with the new setup is detected by STATUS_REG.XLDA,
+  *           cleared by reading OUTX_L_A..OUTZ_H_A once per programmed
+  *           transaction. The accelerometer data-ready edge is consumed
+  *           by the sequencer: the sample is returned in seq->xl_data,
+  *           with seq->xl_drdy set, for the application that also polls
+  *           XLDA (FIFO batched data is not affected).
+  *         - LSM6DSO32_EXT_ON_INT2_PIN: completion is taken from
+  *           SENS_HUB_ENDOP alone and no output register is read. The
+  *           application raises the INT2 trigger after each call that
+  *           programs a transaction and calls again once the cycle is
+  *           over (e.g. from the end of operation interrupt).
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  seq      sequencer state
+  * @param  done     set to 1 when all the transactions are completed
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_sh_seq_step(const stmdev_ctx_t *ctx,
+                              lsm6dso32_sh_seq_t *seq, uint8_t *done)
+{
+  lsm6dso32_status_master_mainpage_t status_master = { 0 };
+  lsm6dso32_master_config_t master_config;
+  lsm6dso32_slv0_config_t slv0_config;
+  lsm6dso32_status_reg_t status_reg;
+  lsm6dso32_sh_xfer_t *xfer;
+  uint8_t complete = PROPERTY_DISABLE;
+  uint8_t program = PROPERTY_DISABLE;
+  uint8_t buff[6];
+  int32_t ret = 0;
+
+  seq->xl_drdy = PROPERTY_DISABLE;
+
+  if (seq->state == LSM6DSO32_SH_SEQ_WAIT_TRIGGER)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_STATUS_REG,
+                             (uint8_t *)&status_reg, 1);
+
+    if ((ret == 0) && (status_reg.xlda == PROPERTY_ENABLE))
+    {
+      seq->state = LSM6DSO32_SH_SEQ_WAIT_ENDOP;
+    }
+  }
+
+  if ((ret == 0) && (seq->state == LSM6DSO32_SH_SEQ_WAIT_ENDOP))
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_STATUS_MASTER_MAINPAGE,
+                             (uint8_t *)&status_master, 1);
+
+    if ((ret == 0) && (status_master.sens_hub_endop == PROPERTY_ENABLE))
+    {
+      complete = PROPERTY_ENABLE;
+    }
+  }
+
+  if ((ret == 0) && (seq->idx < seq->num) &&
+      ((complete == PROPERTY_ENABLE) ||
+       (seq->state == LSM6DSO32_SH_SEQ_IDLE)))
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_SENSOR_HUB_BANK);
+
+    if ((ret == 0) && (complete == PROPERTY_DISABLE))
+    {
+      /* first transaction: sensor hub trigger in use */
+      ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                               (uint8_t *)&master_config, 1);
+      seq->ext_trig = master_config.start_config;
+    }
+
+    if ((ret == 0) && (complete == PROPERTY_ENABLE))
+    {
+      xfer = &seq->xfer[seq->idx];
+      seq->state = LSM6DSO32_SH_SEQ_IDLE;
+
+      if (status_master.slave0_nack == PROPERTY_ENABLE)
+      {
+        xfer->status = LSM6DSO32_SH_XFER_NACK;
+        seq->idx++;
+        seq->ofs = 0U;
+      }
+
+      else if (xfer->rd != PROPERTY_DISABLE)
+      {
+        ret = lsm6dso32_read_reg(ctx, LSM6DSO32_SENSOR_HUB_1,
+                                 xfer->data, xfer->len);
+        xfer->status = LSM6DSO32_SH_XFER_DONE;
+        seq->idx++;
+      }
+
+      else
+      {
+        seq->ofs++;
+
+        if (seq->ofs >= xfer->len)
+        {
+          xfer->status = LSM6DSO32_SH_XFER_DONE;
+          seq->idx++;
+          seq->ofs = 0U;
+        }
+      }
+    }
+
+    if ((ret == 0) && (seq->idx < seq->num))
+    {
+      xfer = &seq->xfer[seq->idx];
+      /* SLV0_ADD and SLV0_SUBADD programmed in one burst */
+      buff[0] = (uint8_t)((uint8_t)(xfer->slv_add << 1) |
+                          ((xfer->rd != PROPERTY_DISABLE) ? 1U : 0U));
+      buff[1] = xfer->slv_subadd + seq->ofs;
+      ret = lsm6dso32_write_reg(ctx, LSM6DSO32_SLV0_ADD, buff, 2);
+
+      if ((ret == 0) && (xfer->rd != PROPERTY_DISABLE))
+      {
+        ret = lsm6dso32_read_reg(ctx, LSM6DSO32_SLV0_CONFIG,
+                                 (uint8_t *)&slv0_config, 1);
+
+        if (ret == 0)
+        {
+          slv0_config.slave0_numop = xfer->len;
+          ret = lsm6dso32_write_reg(ctx, LSM6DSO32_SLV0_CONFIG,
+                                    (uint8_t *)&slv0_config, 1);
+        }
+      }
+
+      else if (ret == 0)
+      {
+        ret = lsm6dso32_write_reg(ctx, LSM6DSO32_DATAWRITE_SLV0,
+                                  &xfer->data[seq->ofs], 1);
+      }
+
+      else
+      {
+        /* interface error */
+      }
+
+      program = PROPERTY_ENABLE;
+    }
+
+    if (ret == 0)
+    {
+      ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+    }
+
+    if ((ret == 0) && (program == PROPERTY_ENABLE) &&
+        (seq->ext_trig == (uint8_t)LSM6DSO32_EXT_ON_INT2_PIN))
+    {
+      /* cycle started by the application through INT2 */
+      seq->state = LSM6DSO32_SH_SEQ_WAIT_ENDOP;
+    }
+
+    /* clear XLDA: the next trigger starts a cycle with the new setup */
+    else if ((ret == 0) && (program == PROPERTY_ENABLE))
+    {
+      ret = lsm6dso32_read_reg(ctx, LSM6DSO32_OUTX_L_A, buff, 6);
+      seq->state = LSM6DSO32_SH_SEQ_WAIT_TRIGGER;
+
+      if (ret == 0)
+      {
+        seq->xl_data[0] = (int16_t)buff[1];
+        seq->xl_data[0] = (seq->xl_data[0] * 256) + (int16_t)buff[0];
+        seq->xl_data[1] = (int16_t)buff[3];
+        seq->xl_data[1] = (seq->xl_data[1] * 256) + (int16_t)buff[2];
+        seq->xl_data[2] = (int16_t)buff[5];
+        seq->xl_data[2] = (seq->xl_data[2] * 256) + (int16_t)buff[4];
+        seq->xl_drdy = PROPERTY_ENABLE;
+      }
+    }
+
+    else
+    {
+      /* sequence completed or interface error */
+    }
+  }
+
+  if (ret == 0)
+  {
+    *done = (seq->idx >= seq->num) ? PROPERTY_ENABLE : PROPERTY_DISABLE;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Execute the sensor hub transaction sequence (blocking).[set]
+  *
+  * @param  ctx         read / write interface definitions
+  * @param  seq         sequencer state (see lsm6dso32_sh_seq_init)
+  * @param  timeout_ms  maximum time to wait, polling every 1 ms
+  *                     (ctx->mdelay is mandatory)
+  * @retval             interface status, -1 also on timeout
+  *
+  */
+int32_t lsm6dso32_sh_seq_run(const stmdev_ctx_t *ctx,
+                             lsm6dso32_sh_seq_t *seq, uint32_t timeout_ms)
+{
+  uint8_t done = PROPERTY_DISABLE;
+  int32_t ret;
+
+  if (ctx->mdelay == NULL)
+  {
+    return -1;
+  }
+
+  ret = lsm6dso32_sh_seq_step(ctx, seq, &done);
+
+  while ((ret == 0) && (done == PROPERTY_DISABLE))
+  {
+    if (timeout_ms == 0U)
+    {
+      ret = -1;
+    }
+
+    else
+    {
+      ctx->mdelay(1);
+      timeout_ms--;
+      ret = lsm6dso32_sh_seq_step(ctx, seq, &done);
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Open a pass-through session towards the auxiliary I2C bus.[set]
+  *
+  *         Sequence: START_CONFIG = 1 (stop hub trigger), wait one sensor
+  *         hub cycle, then MASTER_ON = 0, SHUB_PU_EN = 0 and
+  *         PASS_THROUGH_MODE = 1 in a single write. While the session is
+  *         active the external device is accessed directly through
+  *         pt->aux at host bus speed (e.g. by its own ST driver).
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  pt       session state (zero initialized before first use)
+  * @param  aux      host bus interface addressing the external device
+  *                  (ctx->mdelay is mandatory)
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_sh_pass_through_begin(const stmdev_ctx_t *ctx,
+                                        lsm6dso32_sh_pass_through_t *pt,
+                                        const stmdev_ctx_t *aux)
+{
+  lsm6dso32_master_config_t master_config;
+  lsm6dso32_slv0_config_t slv0_config;
+  uint32_t cycle_ms;
+  int32_t ret;
+
+  if ((ctx->mdelay == NULL) || (pt->active == PROPERTY_ENABLE))
+  {
+    return -1;
+  }
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_SENSOR_HUB_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                             (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_SLV0_CONFIG,
+                             (uint8_t *)&slv0_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    pt->saved = master_config;
+    master_config.start_config = PROPERTY_ENABLE;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                              (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    /* let the ongoing sensor hub cycle complete */
+    switch (slv0_config.shub_odr)
+    {
+      case LSM6DSO32_SH_ODR_104Hz:
+        cycle_ms = 10U;
+        break;
+
+      case LSM6DSO32_SH_ODR_52Hz:
+        cycle_ms = 20U;
+        break;
+
+      case LSM6DSO32_SH_ODR_26Hz:
+        cycle_ms = 39U;
+        break;
+
+      default:
+        cycle_ms = 77U;
+        break;
+    }
+
+    ctx->mdelay(cycle_ms);
+    master_config.master_on = PROPERTY_DISABLE;
+    master_config.shub_pu_en = PROPERTY_DISABLE;
+    master_config.pass_through_mode = PROPERTY_ENABLE;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                              (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  if (ret == 0)
+  {
+    pt->aux = aux;
+    pt->active = PROPERTY_ENABLE;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Close a pass-through session and restore the sensor hub
+  *         configuration saved by lsm6dso32_sh_pass_through_begin.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  pt       session state
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_sh_pass_through_end(const stmdev_ctx_t *ctx,
+                                      lsm6dso32_sh_pass_through_t *pt)
+{
+  lsm6dso32_master_config_t master_config;
+  int32_t ret;
+
+  if (pt->active != PROPERTY_ENABLE)
+  {
+    return -1;
+  }
+
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_SENSOR_HUB_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                             (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    /* leave pass-through before the master can be restarted */
+    master_config.pass_through_mode = PROPERTY_DISABLE;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                              (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                              (uint8_t *)&pt->saved, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  if (ret == 0)
+  {
+    pt->aux = NULL;
+    pt->active = PROPERTY_DISABLE;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Compute sensor hub slave slots for a list of external sensor
+  *         register spans.[get]
+  *
+  *         Spans of the same device are merged when contiguous or
+  *         separated by no more than LSM6DSO32_SH_MERGE_GAP bytes
+  *         (cheaper than a new address/subaddress phase on the aux bus)
+  *         and split in slots of up to 7 bytes. Slots are packed in the
+  *         SENSOR_HUB_1..18 window in slave order and the lowest sensor
+  *         hub ODR satisfying all the requested rates is selected.
+  *         On success sensor[].slot and sensor[].ofs locate each span.
+  *         No register is accessed, see lsm6dso32_sh_plan_apply.
+  *
+  * @param  sensor   list of external sensor spans
+  * @param  num      number of entries (1 to LSM6DSO32_SH_PLAN_MAX_SENSORS)
+  * @param  plan     generated configuration
+  * @retval             0 -> plan found, -1 -> request does not fit
+  *                     (more than 4 slots, 18 bytes or 104 Hz)
+  *
+  */
+int32_t lsm6dso32_sh_plan(lsm6dso32_sh_sensor_t *sensor, uint8_t num,
+                          lsm6dso32_sh_plan_t *plan)
+{
+  uint8_t order[LSM6DSO32_SH_PLAN_MAX_SENSORS];
+  lsm6dso32_sh_sensor_t *s;
+  uint16_t odr_max = 0U;
+  uint16_t start;
+  uint16_t end;
+  uint16_t pos;
+  uint8_t first_slot;
+  uint8_t first_ofs;
+  uint8_t chunk;
+  uint8_t i;
+  uint8_t j;
+  uint8_t k;
+  int32_t ret = 0;
+
+  if ((num == 0U) || (num > LSM6DSO32_SH_PLAN_MAX_SENSORS))
+  {
+    return -1;
+  }
+
+  /* sort spans by device address and first register */
+  for (i = 0U; (ret == 0) && (i < num); i++)
+  {
+    if ((sensor[i].len == 0U) || (sensor[i].len > LSM6DSO32_SH_WINDOW_LEN) ||
+        (((uint16_t)sensor[i].slv_subadd + sensor[i].len) > 256U))
+    {
+      ret = -1;
+    }
+
+    odr_max = (sensor[i].odr_hz > odr_max) ? sensor[i].odr_hz : odr_max;
+    k = i;
+
+    while ((k > 0U) &&
+           ((sensor[order[k - 1U]].slv_add > sensor[i].slv_add) ||
+            ((sensor[order[k - 1U]].slv_add == sensor[i].slv_add) &&
+             (sensor[order[k - 1U]].slv_subadd > sensor[i].slv_subadd))))
+    {
+      order[k] = order[k - 1U];
+      k--;
+    }
+
+    order[k] = i;
+  }
+
+  if (ret == 0)
+  {
+    if (odr_max <= 13U)
+    {
+      plan->odr = LSM6DSO32_SH_ODR_13Hz;
+    }
+
+    else if (odr_max <= 26U)
+    {
+      plan->odr = LSM6DSO32_SH_ODR_26Hz;
+    }
+
+    else if (odr_max <= 52U)
+    {
+      plan->odr = LSM6DSO32_SH_ODR_52Hz;
+    }
+
+    else if (odr_max <= 104U)
+    {
+      plan->odr = LSM6DSO32_SH_ODR_104Hz;
+    }
+
+    else
+    {
+      ret = -1;
+    }
+  }
+
+  plan->num = 0U;
+  plan->bytes = 0U;
+  i = 0U;
+
+  while ((ret == 0) && (i < num))
+  {
+    s = &sensor[order[i]];
+    start = s->slv_subadd;
+    end = start + s->len;
+    j = i + 1U;
+
+    /* merge the following spans of the same device */
+    while ((j < num) && (sensor[order[j]].slv_add == s->slv_add) &&
+           (sensor[order[j]].slv_subadd <= (end + LSM6DSO32_SH_MERGE_GAP)))
+    {
+      pos = (uint16_t)sensor[order[j]].slv_subadd + sensor[order[j]].len;
+      end = (pos > end) ? pos : end;
+      j++;
+    }
+
+    first_slot = plan->num;
+    first_ofs = plan->bytes;
+
+    /* split the merged span in slots */
+    for (pos = start; (ret == 0) && (pos < end);
+         pos += LSM6DSO32_SH_SLOT_MAX_LEN)
+    {
+      chunk = ((uint16_t)(end - pos) > LSM6DSO32_SH_SLOT_MAX_LEN) ?
+              (uint8_t)LSM6DSO32_SH_SLOT_MAX_LEN : (uint8_t)(end - pos);
+
+      if ((plan->num >= 4U) ||
+          ((plan->bytes + chunk) > LSM6DSO32_SH_WINDOW_LEN))
+      {
+        ret = -1;
+      }
+
+      else
+      {
+        plan->slv[plan->num].slv_add = s->slv_add;
+        plan->slv[plan->num].slv_subadd = (uint8_t)pos;
+        plan->slv[plan->num].slv_len = chunk;
+        plan->ofs[plan->num] = plan->bytes;
+        plan->batch[plan->num] = PROPERTY_DISABLE;
+
+        /* batch the slot only if an overlapping span asks for it */
+        for (k = i; k < j; k++)
+        {
+          if ((sensor[order[k]].batch != PROPERTY_DISABLE) &&
+              (sensor[order[k]].slv_subadd < (pos + chunk)) &&
+              (((uint16_t)sensor[order[k]].slv_subadd +
+                sensor[order[k]].len) > pos))
+          {
+            plan->batch[plan->num] = PROPERTY_ENABLE;
+          }
+        }
+
+        plan->bytes += chunk;
+        plan->num++;
+      }
+    }
+
+    for (k = i; (ret == 0) && (k < j); k++)
+    {
+      pos = sensor[order[k]].slv_subadd - start;
+      sensor[order[k]].slot = first_slot +
+                              (uint8_t)(pos / LSM6DSO32_SH_SLOT_MAX_LEN);
+      sensor[order[k]].ofs = first_ofs + (uint8_t)pos;
+    }
+
+    i = j;
+  }
+
+  if (ret == 0)
+  {
+    plan->aux_sens_on = (lsm6dso32_aux_sens_on_t)(plan->num - 1U);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Write a sensor hub plan computed by lsm6dso32_sh_plan.[set]
+  *
+  *         SLV0_ADD to SLV3_CONFIG are written in a single burst
+  *         (overwriting any slave 0 write setup), then AUX_SENS_ON is
+  *         updated in MASTER_CONFIG.
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  plan     configuration to apply
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_sh_plan_apply(const stmdev_ctx_t *ctx,
+                                const lsm6dso32_sh_plan_t *plan)
+{
+  lsm6dso32_master_config_t master_config;
+  lsm6dso32_reg_t slv[12];
+  uint8_t i;
+  int32_t ret;
+
+  for (i = 0U; i < 12U; i++)
+  {
+    slv[i].byte = 0U;
+  }
+
+  for (i = 0U; i < plan->num; i++)
+  {
+    /* read operation: address LSB set */
+    slv[3U * i].byte = (uint8_t)(plan->slv[i].slv_add << 1) | 0x01U;
+    slv[(3U * i) + 1U].byte = plan->slv[i].slv_subadd;
+    /* SLV1..3_CONFIG share the SLV0_CONFIG numop / batch layout */
+    slv[(3U * i) + 2U].slv1_config.slave1_numop = plan->slv[i].slv_len;
+    slv[(3U * i) + 2U].slv1_config.batch_ext_sens_1_en = plan->batch[i];
+  }
+
+  slv[2].slv0_config.shub_odr = (uint8_t)plan->odr;
+  ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_SENSOR_HUB_BANK);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_SLV0_ADD,
+                              (uint8_t *)slv, 12);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                             (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    master_config.aux_sens_on = (uint8_t)plan->aux_sens_on;
+    ret = lsm6dso32_write_reg(ctx, LSM6DSO32_MASTER_CONFIG,
+                              (uint8_t *)&master_config, 1);
+  }
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_mem_bank_set(ctx, LSM6DSO32_USER_BANK);
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+#endif /* LSM6DSO32_FEATURE_SH */
+
+#if LSM6DSO32_FEATURE_ANALYTICS
+
+/**
+  * @defgroup  LSM6DSO32_Analytics
+  * @brief     This section groups all the functions that compute
+  *            statistics on decoded samples (no register access).
+  * @{
+  *
+  */
+
+/**
+  * @brief  Initialize an accelerometer sample-quality monitor.[set]
+  *
+  * @param  qm         quality monitor
+  * @param  fs         accelerometer full scale in use
+  * @param  spike_mg   sample to sample step counted as spike [mg]
+  *
+  */
+void lsm6dso32_qmon_xl_init(lsm6dso32_qmon_t *qm, lsm6dso32_fs_xl_t fs,
+                            float_t spike_mg)
+{
+  uint8_t k;
+
+  switch (fs)
+  {
+    case LSM6DSO32_8g:
+      qm->sens = lsm6dso32_from_fs8_to_mg(1);
+      break;
+
+    case LSM6DSO32_16g:
+      qm->sens = lsm6dso32_from_fs16_to_mg(1);
+      break;
+
+    case LSM6DSO32_32g:
+      qm->sens = lsm6dso32_from_fs32_to_mg(1);
+      break;
+
+    default:
+      qm->sens = lsm6dso32_from_fs4_to_mg(1);
+      break;
+  }
+
+  qm->spike_lsb = (int32_t)(spike_mg / qm->sens);
+  qm->stuck_len = LSM6DSO32_QMON_STUCK_RUN;
+  qm->health.samples = 0U;
+  qm->health.stuck = 0U;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    qm->mean[k] = 0.0;
+    qm->m2[k] = 0.0;
+    qm->last[k] = 0;
+    qm->health.saturated[k] = 0U;
+    qm->health.spikes[k] = 0U;
+    qm->health.stuck_run[k] = 0U;
+    qm->health.mean[k] = 0.0f;
+    qm->health.std[k] = 0.0f;
+  }
+}
+
+/**
+  * @brief  Initialize a gyroscope sample-quality monitor.[set]
+  *
+  * @param  qm           quality monitor
+  * @param  fs           gyroscope full scale in use
+  * @param  spike_mdps   sample to sample step counted as spike [mdps]
+  *
+  */
+void lsm6dso32_qmon_gy_init(lsm6dso32_qmon_t *qm, lsm6dso32_fs_g_t fs,
+                            float_t spike_mdps)
+{
+  float_t sens;
+
+  switch (fs)
+  {
+    case LSM6DSO32_125dps:
+      sens = lsm6dso32_from_fs125_to_mdps(1);
+      break;
+
+    case LSM6DSO32_500dps:
+      sens = lsm6dso32_from_fs500_to_mdps(1);
+      break;
+
+    case LSM6DSO32_1000dps:
+      sens = lsm6dso32_from_fs1000_to_mdps(1);
+      break;
+
+    case LSM6DSO32_2000dps:
+      sens = lsm6dso32_from_fs2000_to_mdps(1);
+      break;
+
+    default:
+      sens = lsm6dso32_from_fs250_to_mdps(1);
+      break;
+  }
+
+  /* same reset, then gyroscope sensitivity */
+  lsm6dso32_qmon_xl_init(qm, LSM6DSO32_4g, 0.0f);
+  qm->sens = sens;
+  qm->spike_lsb = (int32_t)(spike_mdps / sens);
+}
+
+/**
+  * @brief  Update the quality monitor with a batch of samples.[set]
+  *
+  *         Batch sums are plain scalar loops over the contiguous
+  *         triplets (no SIMD intrinsics, the compiler may vectorize
+  *         them) and are merged in the running mean / variance with the
+  *         Chan-Welford update, so memory is O(1) whatever the stream
+  *         length. The standard deviation uses sqrt() from libm.
+  *         Saturation and spikes are counted per axis. An axis is
+  *         flagged stuck after qm->stuck_len identical samples at any
+  *         level (LSM6DSO32_QMON_STUCK_RUN after init, 0 disables the
+  *         check). A still device at a coarse full scale legitimately
+  *         repeats values: raise stuck_len after init in that case.
+  *
+  * @param  qm       quality monitor
+  * @param  data     X, Y, Z triplets of one sensor
+  *                  (e.g. from lsm6dso32_fifo_words_unpack)
+  * @param  num      number of triplets
+  *
+  */
+void lsm6dso32_qmon_update(lsm6dso32_qmon_t *qm, const int16_t *data,
+                           uint16_t num)
+{
+  lsm6dso32_health_t *h = &qm->health;
+  double_t mean_b;
+  double_t m2_b;
+  double_t delta;
+  double_t n_a;
+  double_t n_b;
+  int64_t sum[3] = { 0, 0, 0 };
+  int64_t sum2[3] = { 0, 0, 0 };
+  uint32_t sat[3] = { 0U, 0U, 0U };
+  int32_t v;
+  int32_t step;
+  uint16_t i;
+  uint8_t k;
+
+  if (num == 0U)
+  {
+    return;
+  }
+
+  for (i = 0U; i < num; i++)
+  {
+    for (k = 0U; k < 3U; k++)
+    {
+      v = data[(3U * i) + k];
+      sum[k] += v;
+      sum2[k] += (int64_t)v * v;
+      sat[k] += ((v >= LSM6DSO32_QMON_SAT_LSB) ||
+                 (v <= -LSM6DSO32_QMON_SAT_LSB)) ? 1U : 0U;
+    }
+  }
+
+  /* stuck-at runs and spikes are sequential in time */
+  for (i = 0U; i < num; i++)
+  {
+    for (k = 0U; k < 3U; k++)
+    {
+      v = data[(3U * i) + k];
+      step = v - qm->last[k];
+
+      if ((h->samples > 0U) || (i > 0U))
+      {
+        h->spikes[k] += ((step > qm->spike_lsb) ||
+                         (step < -qm->spike_lsb)) ? 1U : 0U;
+        h->stuck_run[k] = (step == 0) ?
+                          ((h->stuck_run[k] < 0xFFFFU) ?
+                           (h->stuck_run[k] + 1U) : 0xFFFFU) : 0U;
+      }
+
+      qm->last[k] = (int16_t)v;
+    }
+  }
+
+  n_a = (double_t)h->samples;
+  n_b = (double_t)num;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    mean_b = (double_t)sum[k] / n_b;
+    m2_b = (double_t)sum2[k] - ((double_t)sum[k] * mean_b);
+    delta = mean_b - qm->mean[k];
+    qm->mean[k] += delta * n_b / (n_a + n_b);
+    qm->m2[k] += m2_b + (delta * delta * n_a * n_b / (n_a + n_b));
+    h->saturated[k] += sat[k];
+
+    if ((qm->stuck_len != 0U) && (h->stuck_run[k] >= qm->stuck_len))
+    {
+      h->stuck |= (uint8_t)(1U << k);
+    }
+
+    else
+    {
+      h->stuck &= (uint8_t)~(1U << k);
+    }
+  }
+
+  h->samples += num;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    h->mean[k] = (float_t)qm->mean[k] * qm->sens;
+    h->std[k] = (h->samples > 1U) ?
+                (float_t)sqrt(qm->m2[k] / (double_t)(h->samples - 1U)) *
+                qm->sens : 0.0f;
+  }
+}
+
+/**
+  * @brief  Initialize a streaming overlapping Allan deviation.[set]
+  *
+  *         Only the last len cumulative sums per axis are kept, so any
+  *         capture length is processed in O(len) memory; cluster sizes
+  *         are octave spaced up to (len - 1) / 2 samples.
+  *
+  * @param  av       Allan deviation state
+  * @param  buff     caller buffer of 3 * len double_t
+  * @param  len      cumulative sums kept per axis (>= 3)
+  * @param  odr_hz   sample rate (lsm6dso32_odr_actual_get)
+  * @retval             0 -> ok, -1 -> invalid parameters
+  *
+  */
+int32_t lsm6dso32_adev_init(lsm6dso32_adev_t *av, double_t *buff,
+                            uint32_t len, float_t odr_hz)
+{
+  uint32_t m = 1U;
+  uint8_t j;
+  uint8_t k;
+  int32_t ret = 0;
+
+  if ((buff == NULL) || (len < 3U) || (odr_hz <= 0.0f))
+  {
+    ret = -1;
+  }
+
+  else
+  {
+    av->sum = buff;
+    av->len = len;
+    av->n = 0U;
+    av->tau0 = 1.0 / (double_t)odr_hz;
+    av->num_tau = 0U;
+
+    while ((av->num_tau < LSM6DSO32_ADEV_TAUS) && ((2U * m) < len))
+    {
+      av->m[av->num_tau] = m;
+      av->num_tau++;
+      m *= 2U;
+    }
+
+    for (j = 0U; j < LSM6DSO32_ADEV_TAUS; j++)
+    {
+      av->cnt[j] = 0U;
+
+      for (k = 0U; k < 3U; k++)
+      {
+        av->sq[j][k] = 0.0;
+      }
+    }
+
+    for (k = 0U; k < 3U; k++)
+    {
+      av->acc[k] = 0.0;
+      /* cumulative sum before the first sample */
+      av->sum[k * len] = 0.0;
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Push a batch of samples in the Allan deviation.[set]
+  *
+  *         For each new cumulative sum S[n] and cluster size m:
+  *         (S[n] - 2 S[n - m] + S[n - 2m])^2 is accumulated. The axes
+  *         and cluster sizes of one sample are processed in the inner
+  *         loops, touching only the cumulative sums ring.
+  *
+  * @param  av       Allan deviation state
+  * @param  data     X, Y, Z triplets of one sensor
+  * @param  num      number of triplets
+  * @param  sens     sensitivity applied to raw data (e.g. dps / LSB)
+  *
+  */
+void lsm6dso32_adev_push(lsm6dso32_adev_t *av, const int16_t *data,
+                         uint16_t num, float_t sens)
+{
+  const double_t *s;
+  double_t d;
+  uint32_t n;
+  uint32_t m;
+  uint16_t i;
+  uint8_t j;
+  uint8_t k;
+
+  for (i = 0U; i < num; i++)
+  {
+    av->n++;
+    n = av->n;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      av->acc[k] += (double_t)data[(3U * i) + k] * (double_t)sens;
+      av->sum[(k * av->len) + (n % av->len)] = av->acc[k];
+    }
+
+    for (j = 0U; (j < av->num_tau) && ((2U * av->m[j]) <= n); j++)
+    {
+      m = av->m[j];
+
+      for (k = 0U; k < 3U; k++)
+      {
+        s = &av->sum[k * av->len];
+        d = s[n % av->len] - (2.0 * s[(n - m) % av->len]) +
+            s[(n - (2U * m)) % av->len];
+        av->sq[j][k] += d * d;
+      }
+
+      av->cnt[j]++;
+    }
+  }
+}
+
+/**
+  * @brief  Allan deviation and standard noise terms.[get]
+  *
+  *         ARW is read at tau = 1 s (log-log interpolation, -1/2 slope
+  *         extrapolation outside the computed range), bias instability
+  *         is the minimum deviation / 0.664 and rate random walk is
+  *         sigma * sqrt(3 / tau) at the longest cluster.
+  *         For a gyroscope in dps: ARW * 60 -> deg/sqrt(h).
+  *
+  * @param  av       Allan deviation state
+  * @param  val      Allan deviation and noise terms
+  * @retval             0 -> ok, -1 -> not enough samples
+  *
+  */
+int32_t lsm6dso32_adev_get(const lsm6dso32_adev_t *av,
+                           lsm6dso32_adev_result_t *val)
+{
+  double_t tau;
+  double_t sigma;
+  double_t t_a;
+  double_t s_a;
+  double_t min;
+  uint8_t j;
+  uint8_t k;
+  int32_t ret = 0;
+
+  val->num_tau = 0U;
+
+  for (j = 0U; (j < av->num_tau) && (av->cnt[j] > 0U); j++)
+  {
+    tau = (double_t)av->m[j] * av->tau0;
+    val->tau[j] = (float_t)tau;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      val->adev[j][k] = (float_t)sqrt(av->sq[j][k] /
+                                      (2.0 * (double_t)av->m[j] *
+                                       (double_t)av->m[j] *
+                                       (double_t)av->cnt[j]));
+    }
+
+    val->num_tau++;
+  }
+
+  if (val->num_tau == 0U)
+  {
+    ret = -1;
+  }
+
+  for (k = 0U; (ret == 0) && (k < 3U); k++)
+  {
+    /* angle random walk at tau = 1 s */
+    j = 0U;
+
+    while (((j + 1U) < val->num_tau) && (val->tau[j + 1U] <= 1.0f))
+    {
+      j++;
+    }
+
+    t_a = (double_t)val->tau[j];
+    s_a = (double_t)val->adev[j][k];
+
+    if ((t_a < 1.0) && ((j + 1U) < val->num_tau) && (s_a > 0.0) &&
+        (val->adev[j + 1U][k] > 0.0f))
+    {
+      sigma = exp(log(s_a) + ((log((double_t)val->adev[j + 1U][k]) -
+                                log(s_a)) * (0.0 - log(t_a)) /
+                               (log((double_t)val->tau[j + 1U]) - log(t_a))));
+    }
+
+    else
+    {
+      sigma = s_a * sqrt(t_a);
+    }
+
+    val->arw[k] = (float_t)sigma;
+
+    /* bias instability: flat part of the curve */
+    min = (double_t)val->adev[0][k];
+
+    for (j = 1U; j < val->num_tau; j++)
+    {
+      min = ((double_t)val->adev[j][k] < min) ?
+            (double_t)val->adev[j][k] : min;
+    }
+
+    val->bias_instability[k] = (float_t)(min / 0.664);
+
+    /* rate random walk: +1/2 slope read at the longest cluster */
+    j = val->num_tau - 1U;
+    val->rrw[k] = val->adev[j][k] * (float_t)sqrt(3.0 /
+                                                  (double_t)val->tau[j]);
+  }
+
+  return ret;
+}
+
+/* accelerometer sensitivity [mg/LSB] */
+static float_t lsm6dso32_xl_sens(lsm6dso32_fs_xl_t fs)
+{
+  float_t sens;
+
+  switch (fs)
+  {
+    case LSM6DSO32_8g:
+      sens = lsm6dso32_from_fs8_to_mg(1);
+      break;
+
+    case LSM6DSO32_16g:
+      sens = lsm6dso32_from_fs16_to_mg(1);
+      break;
+
+    case LSM6DSO32_32g:
+      sens = lsm6dso32_from_fs32_to_mg(1);
+      break;
+
+    default:
+      sens = lsm6dso32_from_fs4_to_mg(1);
+      break;
+  }
+
+  return sens;
+}
+
+/**
+  * @brief  Read the detector configuration for the software models.[get]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  val      CTRL1_XL and TAP_CFG0 .. FREE_FALL registers
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_det_cfg_get(const stmdev_ctx_t *ctx,
+                              lsm6dso32_det_cfg_t *val)
+{
+  lsm6dso32_reg_t reg[8];
+  int32_t ret;
+
+  ret = lsm6dso32_read_reg(ctx, LSM6DSO32_CTRL1_XL,
+                           (uint8_t *)&val->ctrl1_xl, 1);
+
+  if (ret == 0)
+  {
+    ret = lsm6dso32_read_reg(ctx, LSM6DSO32_TAP_CFG0, (uint8_t *)reg, 8);
+  }
+
+  if (ret == 0)
+  {
+    val->tap_cfg0 = reg[0].tap_cfg0;
+    val->tap_cfg1 = reg[1].tap_cfg1;
+    val->tap_cfg2 = reg[2].tap_cfg2;
+    val->tap_ths_6d = reg[3].tap_ths_6d;
+    val->int_dur2 = reg[4].int_dur2;
+    val->wake_up_ths = reg[5].wake_up_ths;
+    val->wake_up_dur = reg[6].wake_up_dur;
+    val->free_fall = reg[7].free_fall;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Initialize the tap, 6D, free-fall and wake-up models.[set]
+  *
+  * @param  model    detector models
+  * @param  cfg      registers as written in the device
+  *                  (e.g. from lsm6dso32_det_cfg_get)
+  *
+  */
+void lsm6dso32_det_model_init(lsm6dso32_det_model_t *model,
+                              const lsm6dso32_det_cfg_t *cfg)
+{
+  /* free-fall thresholds [mg] and 1 g * sin(68 deg / 47 deg) */
+  static const float_t ff_mg[3] = { 312.0f, 438.0f, 500.0f };
+  static const float_t d6d_mg[2] = { 927.2f, 731.4f };
+  lsm6dso32_reg_t reg;
+  float_t sens = lsm6dso32_xl_sens((lsm6dso32_fs_xl_t)cfg->ctrl1_xl.fs_xl);
+  uint8_t k;
+
+  model->cfg = *cfg;
+  /* 1 LSB = FS / 64 or FS / 256 */
+  model->wu_ths = (int32_t)cfg->wake_up_ths.wk_ths *
+                  ((cfg->wake_up_dur.wake_ths_w == 0U) ? 512 : 128);
+  /* 1 LSB = FS / 32 */
+  model->tap_ths[0] = (int32_t)cfg->tap_cfg1.tap_ths_x * 1024;
+  model->tap_ths[1] = (int32_t)cfg->tap_cfg2.tap_ths_y * 1024;
+  model->tap_ths[2] = (int32_t)cfg->tap_ths_6d.tap_ths_z * 1024;
+  model->ff_ths = (int32_t)(ff_mg[(cfg->free_fall.ff_ths < 2U) ?
+                                  cfg->free_fall.ff_ths : 2U] / sens);
+  model->d6d_ths = (int32_t)(d6d_mg[(cfg->tap_ths_6d.sixd_ths != 0U) ?
+                                    1U : 0U] / sens);
+  model->ff_dur = (uint8_t)((cfg->wake_up_dur.ff_dur << 5) |
+                            cfg->free_fall.ff_dur);
+  model->shock_len = (cfg->int_dur2.shock == 0U) ? 4U :
+                     (uint16_t)(8U * cfg->int_dur2.shock);
+  model->quiet_len = (cfg->int_dur2.quiet == 0U) ? 2U :
+                     (uint16_t)(4U * cfg->int_dur2.quiet);
+  model->latency_len = (cfg->int_dur2.dur == 0U) ? 16U :
+                       (uint16_t)(32U * cfg->int_dur2.dur);
+  model->sleep_len = (cfg->wake_up_dur.sleep_dur == 0U) ? 16U :
+                     (512U * cfg->wake_up_dur.sleep_dur);
+
+  for (k = 0U; k < 3U; k++)
+  {
+    model->prev[k] = 0;
+    model->lp[k] = 0;
+  }
+
+  model->started = 0U;
+  model->wu_cnt = 0U;
+  model->ff_cnt = 0U;
+  model->sleep_cnt = 0U;
+  model->sleep_state = 0U;
+  model->tap_over = 0U;
+  model->tap_src = 0U;
+  model->shock = 0U;
+  model->quiet = 0U;
+  model->latency = 0U;
+  model->d6d_pos = 0U;
+
+  reg.byte = 0U;
+  model->latch.all_int_src = reg.all_int_src;
+  model->latch.wake_up_src = reg.wake_up_src;
+  model->latch.tap_src = reg.tap_src;
+  model->latch.d6d_src = reg.d6d_src;
+}
+
+/**
+  * @brief  Run a batch of accelerometer samples in the models.[get]
+  *
+  *         Each sample goes through the slope filter
+  *         (a[n] - a[n - 1]) / 2 and is compared with the register
+  *         thresholds using ODR based durations (SHOCK, QUIET, DUR,
+  *         WAKE_DUR, FF_DUR, SLEEP_DUR). Free-fall and 6D use the
+  *         unfiltered data. Sources are live, or accumulated until
+  *         lsm6dso32_det_model_ack when LIR is set.
+  *
+  *         The models are not bit-accurate:
+  *         - with slope_fds set the device high-pass filter is replaced
+  *           by a first order approximation;
+  *         - 6D ignores the LPF2 option (CTRL8_XL LOW_PASS_ON_6D) and has no
+  *           hysteresis, so the position can toggle on a threshold
+  *           crossing where the device would keep it.
+  *
+  * @param  model    detector models
+  * @param  data     accelerometer X, Y, Z triplets at the XL ODR
+  * @param  num      number of triplets
+  * @param  src      source registers after each sample (num entries),
+  *                  may be NULL
+  * @retval          number of samples with an interrupt active
+  *
+  */
+uint32_t lsm6dso32_det_model_run(lsm6dso32_det_model_t *model,
+                                 const int16_t *data, uint32_t num,
+                                 lsm6dso32_det_src_t *src)
+{
+  /* TAP_PRIORITY axis order */
+  static const uint8_t prio[8][3] =
+  {
+    { 0U, 1U, 2U }, { 1U, 0U, 2U }, { 0U, 2U, 1U }, { 2U, 1U, 0U },
+    { 0U, 1U, 2U }, { 1U, 2U, 0U }, { 2U, 0U, 1U }, { 2U, 1U, 0U },
+  };
+  const lsm6dso32_det_cfg_t *cfg = &model->cfg;
+  lsm6dso32_det_src_t out;
+  lsm6dso32_reg_t all;
+  lsm6dso32_reg_t wu;
+  lsm6dso32_reg_t tap;
+  lsm6dso32_reg_t d6d;
+  lsm6dso32_reg_t first;
+  const int16_t *a;
+  int32_t d[3];
+  int32_t f[3];
+  int32_t v;
+  uint32_t active = 0U;
+  uint32_t i;
+  uint8_t en[3];
+  uint8_t over;
+  uint8_t below;
+  uint8_t pos;
+  uint8_t axis;
+  uint8_t k;
+
+  en[0] = cfg->tap_cfg0.tap_x_en;
+  en[1] = cfg->tap_cfg0.tap_y_en;
+  en[2] = cfg->tap_cfg0.tap_z_en;
+
+  for (i = 0U; i < num; i++)
+  {
+    a = &data[3U * i];
+    all.byte = 0U;
+    wu.byte = 0U;
+    tap.byte = 0U;
+    d6d.byte = 0U;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      if (cfg->tap_cfg0.slope_fds == PROPERTY_DISABLE)
+      {
+        d[k] = (model->started != 0U) ?
+               (((int32_t)a[k] - (int32_t)model->prev[k]) / 2) : 0;
+      }
+
+      else
+      {
+        model->lp[k] = (model->started != 0U) ?
+                       (model->lp[k] + (((int32_t)a[k] - model->lp[k]) / 4)) :
+                       (int32_t)a[k];
+        d[k] = (int32_t)a[k] - model->lp[k];
+      }
+
+      f[k] = (d[k] < 0) ? -d[k] : d[k];
+      model->prev[k] = a[k];
+    }
+
+    model->started = 1U;
+
+    /* wake-up */
+    wu.wake_up_src.x_wu = (f[0] > model->wu_ths) ? 1U : 0U;
+    wu.wake_up_src.y_wu = (f[1] > model->wu_ths) ? 1U : 0U;
+    wu.wake_up_src.z_wu = (f[2] > model->wu_ths) ? 1U : 0U;
+    over = wu.wake_up_src.x_wu | wu.wake_up_src.y_wu | wu.wake_up_src.z_wu;
+    model->wu_cnt = (over != 0U) ?
+                    ((model->wu_cnt < 0xFFU) ? (model->wu_cnt + 1U) : 0xFFU) :
+                    0U;
+    wu.wake_up_src.wu_ia = (model->wu_cnt > cfg->wake_up_dur.wake_dur) ?
+                           1U : 0U;
+
+    /* activity / inactivity */
+    if (cfg->tap_cfg2.inact_en != 0U)
+    {
+      model->sleep_cnt = (over != 0U) ? 0U : (model->sleep_cnt + 1U);
+
+      if ((model->sleep_state != 0U) && (wu.wake_up_src.wu_ia != 0U))
+      {
+        model->sleep_state = 0U;
+        wu.wake_up_src.sleep_change_ia = 1U;
+      }
+
+      else if ((model->sleep_state == 0U) &&
+               (model->sleep_cnt == model->sleep_len))
+      {
+        model->sleep_state = 1U;
+        wu.wake_up_src.sleep_change_ia = 1U;
+      }
+
+      else
+      {
+        /* no change */
+      }
+    }
+
+    /* free-fall */
+    below = 0U;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      v = (a[k] < 0) ? -(int32_t)a[k] : (int32_t)a[k];
+      below += (v < model->ff_ths) ? 1U : 0U;
+    }
+
+    model->ff_cnt = (below == 3U) ?
+                    ((model->ff_cnt < 0xFFU) ? (model->ff_cnt + 1U) : 0xFFU) :
+                    0U;
+    wu.wake_up_src.ff_ia = (model->ff_cnt > model->ff_dur) ? 1U : 0U;
+
+    /* single / double tap */
+    axis = 3U;
+
+    for (k = 0U; (k < 3U) && (axis == 3U); k++)
+    {
+      if ((en[prio[cfg->tap_cfg1.tap_priority][k]] != 0U) &&
+          (f[prio[cfg->tap_cfg1.tap_priority][k]] >
+           model->tap_ths[prio[cfg->tap_cfg1.tap_priority][k]]))
+      {
+        axis = prio[cfg->tap_cfg1.tap_priority][k];
+      }
+    }
+
+    over = (axis < 3U) ? 1U : 0U;
+    model->latency = (model->latency > 0U) ? (model->latency - 1U) : 0U;
+
+    if (model->quiet > 0U)
+    {
+      /* a new shock inside the quiet window cancels the tap */
+      model->quiet = (over != 0U) ? 0U : (model->quiet - 1U);
+
+      if ((model->quiet == 0U) && (over == 0U))
+      {
+        tap.byte = model->tap_src;
+
+        if ((cfg->wake_up_ths.single_double_tap != 0U) &&
+            (model->latency > 0U))
+        {
+          tap.tap_src.double_tap = 1U;
+          model->latency = 0U;
+        }
+
+        else
+        {
+          tap.tap_src.single_tap = 1U;
+          model->latency = (cfg->wake_up_ths.single_double_tap != 0U) ?
+                           model->latency_len : 0U;
+        }
+
+        tap.tap_src.tap_ia = 1U;
+      }
+    }
+
+    else if (model->shock > 0U)
+    {
+      if (over == 0U)
+      {
+        model->shock = 0U;
+        model->quiet = model->quiet_len;
+      }
+
+      else
+      {
+        /* expiring while over threshold: too long for a tap */
+        model->shock--;
+      }
+    }
+
+    else if ((over != 0U) && (model->tap_over == 0U))
+    {
+      model->shock = model->shock_len;
+      first.byte = 0U;
+      first.tap_src.x_tap = (axis == 0U) ? 1U : 0U;
+      first.tap_src.y_tap = (axis == 1U) ? 1U : 0U;
+      first.tap_src.z_tap = (axis == 2U) ? 1U : 0U;
+      first.tap_src.tap_sign = (d[axis] < 0) ? 1U : 0U;
+      model->tap_src = first.byte;
+    }
+
+    else
+    {
+      /* wait for a rising edge */
+    }
+
+    model->tap_over = over;
+
+    /* 6D / 4D orientation */
+    pos = 0U;
+
+    for (k = 0U; k < ((cfg->tap_ths_6d.d4d_en != 0U) ? 2U : 3U); k++)
+    {
+      pos |= ((int32_t)a[k] < -model->d6d_ths) ? (uint8_t)(1U << (2U * k)) :
+             0U;
+      pos |= ((int32_t)a[k] > model->d6d_ths) ?
+             (uint8_t)(1U << ((2U * k) + 1U)) : 0U;
+    }
+
+    if ((pos != 0U) && (pos != model->d6d_pos))
+    {
+      model->d6d_pos = pos;
+      d6d.d6d_src.d6d_ia = 1U;
+    }
+
+    d6d.byte |= model->d6d_pos;
+
+    all.all_int_src.ff_ia = wu.wake_up_src.ff_ia;
+    all.all_int_src.wu_ia = wu.wake_up_src.wu_ia;
+    all.all_int_src.single_tap = tap.tap_src.single_tap;
+    all.all_int_src.double_tap = tap.tap_src.double_tap;
+    all.all_int_src.d6d_ia = d6d.d6d_src.d6d_ia;
+    all.all_int_src.sleep_change_ia = wu.wake_up_src.sleep_change_ia;
+    active += (all.byte != 0U) ? 1U : 0U;
+
+    if (cfg->tap_cfg0.lir != PROPERTY_DISABLE)
+    {
+      *(uint8_t *)&model->latch.all_int_src |= all.byte;
+      *(uint8_t *)&model->latch.wake_up_src |= wu.byte;
+      *(uint8_t *)&model->latch.tap_src |= tap.byte;
+      *(uint8_t *)&model->latch.d6d_src |= d6d.byte;
+      out = model->latch;
+    }
+
+    else
+    {
+      out.all_int_src = all.all_int_src;
+      out.wake_up_src = wu.wake_up_src;
+      out.tap_src = tap.tap_src;
+      out.d6d_src = d6d.d6d_src;
+    }
+
+    out.wake_up_src.sleep_state = model->sleep_state;
+
+    if (src != NULL)
+    {
+      src[i] = out;
+    }
+  }
+
+  return active;
+}
+
+/**
+  * @brief  Clear the latched model sources, as reading ALL_INT_SRC.[set]
+  *
+  * @param  model    detector models
+  *
+  */
+void lsm6dso32_det_model_ack(lsm6dso32_det_model_t *model)
+{
+  lsm6dso32_reg_t reg;
+
+  reg.byte = 0U;
+  model->latch.all_int_src = reg.all_int_src;
+  model->latch.wake_up_src = reg.wake_up_src;
+  model->latch.tap_src = reg.tap_src;
+  model->latch.d6d_src = reg.d6d_src;
+}
+
+/* detector configuration of one tuner setting */
+static void lsm6dso32_tune_cfg(lsm6dso32_tune_det_t det,
+                               lsm6dso32_fs_xl_t fs,
+                               const lsm6dso32_tune_t *val,
+                               lsm6dso32_det_cfg_t *cfg)
+{
+  lsm6dso32_reg_t reg;
+
+  reg.byte = 0U;
+  cfg->ctrl1_xl = reg.ctrl1_xl;
+  cfg->tap_cfg0 = reg.tap_cfg0;
+  cfg->tap_cfg1 = reg.tap_cfg1;
+  cfg->tap_cfg2 = reg.tap_cfg2;
+  cfg->tap_ths_6d = reg.tap_ths_6d;
+  cfg->int_dur2 = reg.int_dur2;
+  cfg->wake_up_ths = reg.wake_up_ths;
+  cfg->wake_up_dur = reg.wake_up_dur;
+  cfg->free_fall = reg.free_fall;
+  cfg->ctrl1_xl.fs_xl = (uint8_t)fs;
+
+  switch (det)
+  {
+    case LSM6DSO32_TUNE_WAKE_UP:
+      cfg->wake_up_ths.wk_ths = val->ths;
+      cfg->wake_up_dur.wake_dur = val->dur;
+      break;
+
+    case LSM6DSO32_TUNE_SINGLE_TAP:
+      cfg->tap_cfg0.tap_x_en = PROPERTY_ENABLE;
+      cfg->tap_cfg0.tap_y_en = PROPERTY_ENABLE;
+      cfg->tap_cfg0.tap_z_en = PROPERTY_ENABLE;
+      /* TAP_PRIORITY X-Y-Z */
+      cfg->tap_cfg1.tap_priority = 0U;
+      /* SINGLE_DOUBLE_TAP: single tap only */
+      cfg->wake_up_ths.single_double_tap = 0U;
+      cfg->tap_cfg1.tap_ths_x = val->ths;
+      cfg->tap_cfg2.tap_ths_y = val->ths;
+      cfg->tap_ths_6d.tap_ths_z = val->ths;
+      cfg->int_dur2.shock = val->dur;
+      cfg->int_dur2.quiet = val->quiet;
+      break;
+
+    default:
+      cfg->free_fall.ff_ths = val->ths;
+      cfg->free_fall.ff_dur = val->dur & 0x1FU;
+      cfg->wake_up_dur.ff_dur = (val->dur & 0x20U) >> 5;
+      break;
+  }
+}
+
+/*
+ * Replay one capture through the detector model and score the rising
+ * edges of its source against the labels: an event within window
+ * samples from a label detects it, any other event is false.
+ */
+static void lsm6dso32_tune_score(lsm6dso32_tune_det_t det,
+                                 const lsm6dso32_det_cfg_t *cfg,
+                                 const lsm6dso32_tune_capture_t *cap,
+                                 uint16_t window, lsm6dso32_tune_t *val)
+{
+  lsm6dso32_det_model_t model;
+  lsm6dso32_det_src_t src;
+  uint32_t i;
+  uint16_t p = 0U;
+  uint8_t hit = 0U;
+  uint8_t last = 0U;
+  uint8_t ia;
+
+  lsm6dso32_det_model_init(&model, cfg);
+  val->labeled += cap->num_event;
+
+  /* one sample per model call: no source buffer on the stack */
+  for (i = 0U; i < cap->num; i++)
+  {
+    (void)lsm6dso32_det_model_run(&model, &cap->data[3U * i], 1U, &src);
+
+    switch (det)
+    {
+      case LSM6DSO32_TUNE_WAKE_UP:
+        ia = src.wake_up_src.wu_ia;
+        break;
+
+      case LSM6DSO32_TUNE_SINGLE_TAP:
+        ia = src.tap_src.single_tap;
+        break;
+
+      default:
+        ia = src.wake_up_src.ff_ia;
+        break;
+    }
+
+    /* labels closed before this sample */
+    while ((p < cap->num_event) && ((cap->event[p] + window) < i))
+    {
+      p++;
+      hit = 0U;
+    }
+
+    if ((ia != 0U) && (last == 0U))
+    {
+      if ((p < cap->num_event) && (cap->event[p] <= (i + window)))
+      {
+        val->detected += (hit == 0U) ? 1U : 0U;
+        hit = 1U;
+      }
+
+      else
+      {
+        val->false_evt++;
+      }
+    }
+
+    last = ia;
+  }
+}
+
+/**
+  * @brief  Tune a detector on labeled captures.[get]
+  *
+  *         Every threshold / duration / quiet setting of the detector is
+  *         replayed through lsm6dso32_det_model_run with the registers
+  *         the setting would write. Among the settings reaching target_rate the
+  *         one with the fewest false events is returned, ties going to
+  *         the highest detection count.
+  *
+  * @param  det          detector to tune
+  * @param  fs           accelerometer full scale of the captures
+  * @param  cap          labeled captures (raw LSB at the detector ODR)
+  * @param  num_cap      number of captures
+  * @param  window       label matching tolerance [samples]
+  * @param  target_rate  minimum detected / labeled ratio
+  * @param  val          selected setting and its score
+  * @retval                 0 -> target reached,
+  *                        -1 -> best detection rate setting returned
+  *
+  */
+int32_t lsm6dso32_tune_run(lsm6dso32_tune_det_t det, lsm6dso32_fs_xl_t fs,
+                           const lsm6dso32_tune_capture_t *cap,
+                           uint8_t num_cap, uint16_t window,
+                           float_t target_rate, lsm6dso32_tune_t *val)
+{
+  lsm6dso32_det_cfg_t cfg;
+  lsm6dso32_tune_t t;
+  lsm6dso32_tune_t best;
+  uint8_t ths_min = 1U;
+  uint8_t ths_max;
+  uint8_t dur_max;
+  uint8_t quiet_max = 0U;
+  uint8_t feasible = 0U;
+  uint8_t ok;
+  uint8_t better;
+  uint8_t c;
+  int32_t ret;
+
+  switch (det)
+  {
+    case LSM6DSO32_TUNE_WAKE_UP:
+      ths_max = 63U;
+      dur_max = 3U;
+      break;
+
+    case LSM6DSO32_TUNE_SINGLE_TAP:
+      ths_max = 31U;
+      dur_max = 3U;
+      quiet_max = 3U;
+      break;
+
+    default:
+      ths_min = 0U;
+      /* FF_THS 312 mg .. 500 mg */
+      ths_max = 2U;
+      dur_max = 63U;
+      break;
+  }
+
+  best.ths = ths_min;
+  best.dur = 0U;
+  best.quiet = 0U;
+  best.labeled = 0U;
+  best.detected = 0U;
+  best.false_evt = 0xFFFFFFFFU;
+
+  for (t.ths = ths_min; t.ths <= ths_max; t.ths++)
+  {
+    for (t.dur = 0U; t.dur <= dur_max; t.dur++)
+    {
+      for (t.quiet = 0U; t.quiet <= quiet_max; t.quiet++)
+      {
+        t.labeled = 0U;
+        t.detected = 0U;
+        t.false_evt = 0U;
+        lsm6dso32_tune_cfg(det, fs, &t, &cfg);
+
+        for (c = 0U; c < num_cap; c++)
+        {
+          lsm6dso32_tune_score(det, &cfg, &cap[c], window, &t);
+        }
+
+        ok = ((float_t)t.detected >= (target_rate * (float_t)t.labeled)) ?
+             1U : 0U;
+
+        if (ok != feasible)
+        {
+          better = ok;
+        }
+
+        else if (ok != 0U)
+        {
+          better = ((t.false_evt < best.false_evt) ||
+                    ((t.false_evt == best.false_evt) &&
+                     (t.detected > best.detected))) ? 1U : 0U;
+        }
+
+        else
+        {
+          better = ((t.detected > best.detected) ||
+                    ((t.detected == best.detected) &&
+                     (t.false_evt < best.false_evt))) ? 1U : 0U;
+        }
+
+        if (better != 0U)
+        {
+          best = t;
+          feasible = ok;
+        }
+      }
+    }
+  }
+
+  *val = best;
+  ret = (feasible != 0U) ? 0 : -1;
+
+  return ret;
+}
+
+#if LSM6DSO32_FEATURE_TAP
+/**
+  * @brief  Write a tuned detector setting.[set]
+  *
+  * @param  ctx      read / write interface definitions
+  * @param  det      tuned detector
+  * @param  val      setting from lsm6dso32_tune_run
+  * @retval             interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t lsm6dso32_tune_apply(const stmdev_ctx_t *ctx,
+                             lsm6dso32_tune_det_t det,
+                             const lsm6dso32_tune_t *val)
+{
+  int32_t ret;
+
+  switch (det)
+  {
+    case LSM6DSO32_TUNE_WAKE_UP:
+      ret = lsm6dso32_wkup_ths_weight_set(ctx, LSM6DSO32_LSb_FS_DIV_64);
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_wkup_threshold_set(ctx, val->ths);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_wkup_dur_set(ctx, val->dur);
+      }
+
+      break;
+
+    case LSM6DSO32_TUNE_SINGLE_TAP:
+      /* same axes, priority and mode as the tuned model */
+      ret = lsm6dso32_tap_detection_on_x_set(ctx, PROPERTY_ENABLE);
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_detection_on_y_set(ctx, PROPERTY_ENABLE);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_detection_on_z_set(ctx, PROPERTY_ENABLE);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_axis_priority_set(ctx, LSM6DSO32_XYZ);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_mode_set(ctx, LSM6DSO32_ONLY_SINGLE);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_threshold_x_set(ctx, val->ths);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_threshold_y_set(ctx, val->ths);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_threshold_z_set(ctx, val->ths);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_shock_set(ctx, val->dur);
+      }
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_tap_quiet_set(ctx, val->quiet);
+      }
+
+      break;
+
+    default:
+      ret = lsm6dso32_ff_threshold_set(ctx, (lsm6dso32_ff_ths_t)val->ths);
+
+      if (ret == 0)
+      {
+        ret = lsm6dso32_ff_dur_set(ctx, val->dur);
+      }
+
+      break;
+  }
+
+  return ret;
+}
+#endif /* LSM6DSO32_FEATURE_TAP */
+
+/**
+  * @}
+  *
+  */
+
+#endif /* LSM6DSO32_FEATURE_ANALYTICS */
 
 /**
   * @}
@@ -2629,6 +2629,47 @@ typedef union
 #define __weak __attribute__((weak))
 #endif /* __weak */
 
+/*
+ * Memory barrier used by the lock-free logs shared between interrupt
+ * and thread context. It can be overridden by the application.
+ */
+#ifndef LSM6DSO32_MEM_BARRIER
+#if defined(__GNUC__)
+#define LSM6DSO32_MEM_BARRIER() __sync_synchronize()
+#else
+#define LSM6DSO32_MEM_BARRIER()
+#endif /* __GNUC__ */
+#endif /* LSM6DSO32_MEM_BARRIER */
+
+/*
+ * Feature switches: define one of them to 0 (e.g. -DLSM6DSO32_FEATURE_SH=0)
+ * to exclude the whole section from the build. The register map, the
+ * data path, FIFO, interrupt routing and wake-up/activity are always
+ * built.
+ */
+#ifndef LSM6DSO32_FEATURE_SH
+#define LSM6DSO32_FEATURE_SH          1  /* sensor hub */
+#endif /* LSM6DSO32_FEATURE_SH */
+#ifndef LSM6DSO32_FEATURE_FSM
+#define LSM6DSO32_FEATURE_FSM         1  /* finite state machine */
+#endif /* LSM6DSO32_FEATURE_FSM */
+#ifndef LSM6DSO32_FEATURE_PEDO
+#define LSM6DSO32_FEATURE_PEDO        1  /* pedometer, tilt, sig. motion */
+#endif /* LSM6DSO32_FEATURE_PEDO */
+#ifndef LSM6DSO32_FEATURE_MAG
+#define LSM6DSO32_FEATURE_MAG         1  /* magnetometer calibration */
+#endif /* LSM6DSO32_FEATURE_MAG */
+#ifndef LSM6DSO32_FEATURE_TAP
+#define LSM6DSO32_FEATURE_TAP         1  /* tap, 6D/4D, free-fall */
+#endif /* LSM6DSO32_FEATURE_TAP */
+#ifndef LSM6DSO32_FEATURE_DEN
+#define LSM6DSO32_FEATURE_DEN         1  /* data enable */
+#endif /* LSM6DSO32_FEATURE_DEN */
+#ifndef LSM6DSO32_FEATURE_ANALYTICS
+#define LSM6DSO32_FEATURE_ANALYTICS   1  /* host side analysis tools,
+                                            uses libm (sqrt, exp, log) */
+#endif /* LSM6DSO32_FEATURE_ANALYTICS */
+
 /*
  * These are the basic platform dependent I/O routines to read
  * and write device registers connected on a standard bus.
@@ -2816,6 +2857,48 @@ int32_t lsm6dso32_timestamp_get(const stmdev_ctx_t *ctx, uint8_t *val);
 
 int32_t lsm6dso32_timestamp_raw_get(const stmdev_ctx_t *ctx, uint32_t *val);
 
+int32_t lsm6dso32_odr_actual_get(const stmdev_ctx_t *ctx,
+                                 float_t *xl_hz, float_t *gy_hz);
+int32_t lsm6dso32_timestamp_lsb_get(const stmdev_ctx_t *ctx, float_t *val);
+
+#define LSM6DSO32_ODR_DRIFT_WINDOW_TICKS  400000U  /* 10 s */
+
+typedef struct
+{
+  float_t   lsb_us;     /* timestamp LSB [us] */
+  float_t   period_us;  /* sample period [us] */
+  uint32_t  ts0;        /* device timestamp at window start */
+  uint32_t  host0;      /* host time at window start [us] */
+  uint32_t  samples;    /* samples in current window */
+  uint8_t   started;
+  uint8_t   windows;    /* completed windows */
+} lsm6dso32_odr_drift_t;
+void lsm6dso32_odr_drift_init(lsm6dso32_odr_drift_t *drift, float_t lsb_us,
+                              float_t odr_hz);
+void lsm6dso32_odr_drift_update(lsm6dso32_odr_drift_t *drift, uint32_t ts,
+                                uint32_t host_us, uint32_t samples);
+
+#define LSM6DSO32_SYNC_PAIRS  16U
+
+typedef struct
+{
+  int64_t   dev[LSM6DSO32_SYNC_PAIRS];   /* unwrapped device ticks */
+  uint64_t  host[LSM6DSO32_SYNC_PAIRS];  /* host time [us] */
+  uint8_t   num;                         /* valid pairs */
+  uint8_t   idx;                         /* next pair to overwrite */
+  uint32_t  last_ts;                     /* last raw device timestamp */
+  int64_t   last_dev;                    /* last unwrapped timestamp */
+  double_t  offset_us;                   /* host = offset + skew * ticks */
+  double_t  skew_us;                     /* host us per device tick */
+} lsm6dso32_sync_t;
+void lsm6dso32_sync_init(lsm6dso32_sync_t *sync);
+void lsm6dso32_sync_add(lsm6dso32_sync_t *sync, uint32_t ts,
+                        uint64_t host_us);
+int32_t lsm6dso32_sync_sample(const stmdev_ctx_t *ctx, lsm6dso32_sync_t *sync,
+                              uint64_t host_us);
+int32_t lsm6dso32_sync_to_host(const lsm6dso32_sync_t *sync, uint32_t ts,
+                               double_t *host_us);
+
 typedef enum
 {
   LSM6DSO32_NO_ROUND      = 0,
@@ -2867,6 +2950,32 @@ int32_t lsm6dso32_ln_pg_write(const stmdev_ctx_t *ctx, uint16_t address,
 int32_t lsm6dso32_ln_pg_read(const stmdev_ctx_t *ctx, uint16_t address, uint8_t *buf,
                              uint8_t len);
 
+typedef struct
+{
+  uint16_t  address;
+  uint8_t   *buf;
+  uint8_t   len;
+} lsm6dso32_pg_span_t;
+int32_t lsm6dso32_ln_pg_read_spans(const stmdev_ctx_t *ctx,
+                                   const lsm6dso32_pg_span_t *span,
+                                   uint8_t num);
+
+#define LSM6DSO32_EMB_SNAPSHOT_REG_LEN   13U
+#define LSM6DSO32_EMB_SNAPSHOT_PAGE_LEN  31U
+
+typedef struct
+{
+  /* EMB_FUNC_EN_A/B, EMB_FUNC_INT1..FSM_INT1_B, EMB_FUNC_INT2..FSM_INT2_B,
+     PAGE_RW, EMB_FUNC_FIFO_CFG, FSM_ENABLE_A/B, EMB_FUNC_ODR_CFG_B */
+  uint8_t reg[LSM6DSO32_EMB_SNAPSHOT_REG_LEN];
+  /* magnetometer calibration, FSM and pedometer configuration pages */
+  uint8_t page[LSM6DSO32_EMB_SNAPSHOT_PAGE_LEN];
+} lsm6dso32_emb_snapshot_t;
+int32_t lsm6dso32_emb_snapshot_get(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_emb_snapshot_t *val);
+int32_t lsm6dso32_emb_snapshot_set(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_emb_snapshot_t *val);
+
 typedef enum
 {
   LSM6DSO32_DRDY_LATCHED = 0,
@@ -2888,6 +2997,71 @@ int32_t lsm6dso32_auto_increment_get(const stmdev_ctx_t *ctx, uint8_t *val);
 int32_t lsm6dso32_boot_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t lsm6dso32_boot_get(const stmdev_ctx_t *ctx, uint8_t *val);
 
+typedef struct
+{
+  lsm6dso32_pin_ctrl_t          pin_ctrl;
+  lsm6dso32_fifo_ctrl1_t        fifo_ctrl1;
+  lsm6dso32_fifo_ctrl2_t        fifo_ctrl2;
+  lsm6dso32_fifo_ctrl3_t        fifo_ctrl3;
+  lsm6dso32_fifo_ctrl4_t        fifo_ctrl4;
+  lsm6dso32_counter_bdr_reg1_t  counter_bdr_reg1;
+  lsm6dso32_counter_bdr_reg2_t  counter_bdr_reg2;
+  lsm6dso32_int1_ctrl_t         int1_ctrl;
+  lsm6dso32_int2_ctrl_t         int2_ctrl;
+  lsm6dso32_ctrl1_xl_t          ctrl1_xl;
+  lsm6dso32_ctrl2_g_t           ctrl2_g;
+  lsm6dso32_ctrl3_c_t           ctrl3_c;
+  lsm6dso32_ctrl4_c_t           ctrl4_c;
+  lsm6dso32_ctrl5_c_t           ctrl5_c;
+  lsm6dso32_ctrl6_c_t           ctrl6_c;
+  lsm6dso32_ctrl7_g_t           ctrl7_g;
+  lsm6dso32_ctrl8_xl_t          ctrl8_xl;
+  lsm6dso32_ctrl9_xl_t          ctrl9_xl;
+  lsm6dso32_ctrl10_c_t          ctrl10_c;
+  lsm6dso32_tap_cfg0_t          tap_cfg0;
+  lsm6dso32_tap_cfg1_t          tap_cfg1;
+  lsm6dso32_tap_cfg2_t          tap_cfg2;
+  lsm6dso32_tap_ths_6d_t        tap_ths_6d;
+  lsm6dso32_int_dur2_t          int_dur2;
+  lsm6dso32_wake_up_ths_t       wake_up_ths;
+  lsm6dso32_wake_up_dur_t       wake_up_dur;
+  lsm6dso32_free_fall_t         free_fall;
+  lsm6dso32_md1_cfg_t           md1_cfg;
+  lsm6dso32_md2_cfg_t           md2_cfg;
+  lsm6dso32_i3c_bus_avb_t       i3c_bus_avb;
+  uint8_t                       x_ofs_usr;
+  uint8_t                       y_ofs_usr;
+  uint8_t                       z_ofs_usr;
+} lsm6dso32_state_t;
+int32_t lsm6dso32_state_save(const stmdev_ctx_t *ctx,
+                             lsm6dso32_state_t *val);
+int32_t lsm6dso32_state_restore(const stmdev_ctx_t *ctx,
+                                lsm6dso32_state_t *val);
+
+typedef enum
+{
+  LSM6DSO32_INIT_ID_CHECK   = 0,
+  LSM6DSO32_INIT_RESET_WAIT = 1,
+  LSM6DSO32_INIT_CONFIG     = 2,
+  LSM6DSO32_INIT_DONE       = 3,
+  LSM6DSO32_INIT_ERROR      = 4,
+} lsm6dso32_init_state_t;
+
+#define LSM6DSO32_INIT_BACKOFF_MAX_MS  16U
+#define LSM6DSO32_INIT_TIMEOUT_MS      100U
+
+typedef struct
+{
+  lsm6dso32_init_state_t  state;
+  lsm6dso32_state_t       *cfg;        /* configuration to restore or NULL */
+  uint32_t                wait_ms;     /* time left before next poll */
+  uint32_t                backoff_ms;  /* current poll interval */
+  uint32_t                elapsed_ms;  /* time spent in current state */
+} lsm6dso32_init_t;
+void lsm6dso32_init_start(lsm6dso32_init_t *init, lsm6dso32_state_t *cfg);
+int32_t lsm6dso32_init_step(const stmdev_ctx_t *ctx, lsm6dso32_init_t *init,
+                            uint32_t elapsed_ms, uint32_t *next_ms);
+
 typedef enum
 {
   LSM6DSO32_XL_ST_DISABLE  = 0,
@@ -2910,6 +3084,47 @@ int32_t lsm6dso32_gy_self_test_set(const stmdev_ctx_t *ctx,
 int32_t lsm6dso32_gy_self_test_get(const stmdev_ctx_t *ctx,
                                    lsm6dso32_st_g_t *val);
 
+#define LSM6DSO32_SELF_TEST_SAMPLES     5U
+#define LSM6DSO32_SELF_TEST_SETTLE_MS   100U
+#define LSM6DSO32_SELF_TEST_POLL_MS     20U
+#define LSM6DSO32_SELF_TEST_TIMEOUT_MS  500U
+#define LSM6DSO32_XL_ST_MIN_MG          50.0f    /* @ 4g */
+#define LSM6DSO32_XL_ST_MAX_MG          1700.0f  /* @ 4g */
+#define LSM6DSO32_GY_ST_MIN_DPS         150.0f   /* @ 2000dps */
+#define LSM6DSO32_GY_ST_MAX_DPS         700.0f   /* @ 2000dps */
+
+typedef enum
+{
+  LSM6DSO32_SELF_TEST_XL_NOST  = 0,
+  LSM6DSO32_SELF_TEST_XL_ST    = 1,
+  LSM6DSO32_SELF_TEST_GY_NOST  = 2,
+  LSM6DSO32_SELF_TEST_GY_ST    = 3,
+  LSM6DSO32_SELF_TEST_DONE     = 4,
+  LSM6DSO32_SELF_TEST_ERROR    = 5,
+} lsm6dso32_self_test_state_t;
+
+typedef struct
+{
+  lsm6dso32_self_test_state_t  state;
+  uint8_t                      phase;       /* 0 setup, 1 settle, 2 collect */
+  uint32_t                     wait_ms;
+  uint32_t                     elapsed_ms;  /* time spent collecting */
+  int32_t                      sum[3];
+  uint8_t                      cnt;
+  float_t                      nost[3];     /* average without self-test */
+  lsm6dso32_state_t            saved;       /* configuration before test */
+  /* result */
+  float_t                      xl_mg[3];    /* ST - NOST */
+  float_t                      gy_dps[3];   /* ST - NOST */
+  uint8_t                      xl_pass;
+  uint8_t                      gy_pass;
+} lsm6dso32_self_test_t;
+int32_t lsm6dso32_self_test_start(const stmdev_ctx_t *ctx,
+                                  lsm6dso32_self_test_t *st);
+int32_t lsm6dso32_self_test_step(const stmdev_ctx_t *ctx,
+                                 lsm6dso32_self_test_t *st,
+                                 uint32_t elapsed_ms, uint32_t *next_ms);
+
 int32_t lsm6dso32_xl_filter_lp2_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t lsm6dso32_xl_filter_lp2_get(const stmdev_ctx_t *ctx, uint8_t *val);
 
@@ -3078,6 +3293,56 @@ int32_t lsm6dso32_pin_int2_route_set(const stmdev_ctx_t *ctx,
 int32_t lsm6dso32_pin_int2_route_get(const stmdev_ctx_t *ctx,
                                      lsm6dso32_pin_int2_route_t *val);
 
+typedef struct
+{
+  lsm6dso32_int1_ctrl_t          int1_ctrl;
+  lsm6dso32_md1_cfg_t            md1_cfg;
+  lsm6dso32_int2_ctrl_t          int2_ctrl;
+  lsm6dso32_md2_cfg_t            md2_cfg;
+  uint8_t                        interrupts_enable;  /* TAP_CFG2 */
+  uint8_t                        emb_int1[3];  /* EMB_FUNC_INT1..FSM_INT1_B */
+  uint8_t                        emb_int2[3];  /* EMB_FUNC_INT2..FSM_INT2_B */
+  uint8_t                        emb_int1_valid;
+  uint8_t                        emb_int2_valid;
+} lsm6dso32_pin_int_cache_t;
+int32_t lsm6dso32_pin_int_cache_init(const stmdev_ctx_t *ctx,
+                                     lsm6dso32_pin_int_cache_t *val);
+int32_t lsm6dso32_pin_int1_route_cached_set(const stmdev_ctx_t *ctx,
+                                            lsm6dso32_pin_int_cache_t *cache,
+                                            lsm6dso32_pin_int1_route_t *val);
+int32_t lsm6dso32_pin_int2_route_cached_set(const stmdev_ctx_t *ctx,
+                                            lsm6dso32_pin_int_cache_t *cache,
+                                            lsm6dso32_pin_int2_route_t *val);
+
+typedef struct
+{
+  lsm6dso32_pin_int1_route_t     int1;
+  lsm6dso32_pin_int2_route_t     int2;
+} lsm6dso32_pin_int_route_t;
+int32_t lsm6dso32_pin_int_route_set(const stmdev_ctx_t *ctx,
+                                    lsm6dso32_pin_int_cache_t *cache,
+                                    lsm6dso32_pin_int_route_t *val);
+int32_t lsm6dso32_pin_int_route_get(const stmdev_ctx_t *ctx,
+                                    lsm6dso32_pin_int_route_t *val);
+
+typedef struct
+{
+  uint8_t  user_len;  /* sources read from ALL_INT_SRC (0 to 4) */
+  uint8_t  emb_len;   /* sources read from EMB_FUNC_STATUS_MAINPAGE (0 to 3) */
+} lsm6dso32_int_ack_mask_t;
+
+typedef enum
+{
+  LSM6DSO32_ACK_WITH_SOURCES = 0,  /* + sources identifying the event */
+  LSM6DSO32_ACK_MINIMAL      = 1,  /* ALL_INT_SRC only (releases latch) */
+} lsm6dso32_int_ack_mode_t;
+void lsm6dso32_int_ack_mask_get(const lsm6dso32_pin_int_route_t *route,
+                                lsm6dso32_int_ack_mode_t mode,
+                                lsm6dso32_int_ack_mask_t *val);
+int32_t lsm6dso32_int_ack(const stmdev_ctx_t *ctx,
+                          const lsm6dso32_int_ack_mask_t *mask,
+                          lsm6dso32_all_sources_t *val);
+
 typedef enum
 {
   LSM6DSO32_PUSH_PULL   = 0,
@@ -3162,6 +3427,7 @@ int32_t lsm6dso32_act_mode_get(const stmdev_ctx_t *ctx,
 int32_t lsm6dso32_act_sleep_dur_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t lsm6dso32_act_sleep_dur_get(const stmdev_ctx_t *ctx, uint8_t *val);
 
+#if LSM6DSO32_FEATURE_TAP
 int32_t lsm6dso32_tap_detection_on_z_set(const stmdev_ctx_t *ctx,
                                          uint8_t val);
 int32_t lsm6dso32_tap_detection_on_z_get(const stmdev_ctx_t *ctx,
@@ -3248,6 +3514,7 @@ int32_t lsm6dso32_ff_threshold_get(const stmdev_ctx_t *ctx,
 
 int32_t lsm6dso32_ff_dur_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t lsm6dso32_ff_dur_get(const stmdev_ctx_t *ctx, uint8_t *val);
+#endif /* LSM6DSO32_FEATURE_TAP */
 
 int32_t lsm6dso32_fifo_watermark_set(const stmdev_ctx_t *ctx, uint16_t val);
 int32_t lsm6dso32_fifo_watermark_get(const stmdev_ctx_t *ctx,
@@ -3446,6 +3713,98 @@ int32_t lsm6dso32_sh_batch_slave_3_set(const stmdev_ctx_t *ctx,
 int32_t lsm6dso32_sh_batch_slave_3_get(const stmdev_ctx_t *ctx,
                                        uint8_t *val);
 
+typedef struct
+{
+  lsm6dso32_fifo_tag_t  tag;
+  uint8_t               cnt;        /* TAG_CNT (0 to 3) */
+  uint32_t              timestamp;  /* last TIMESTAMP_TAG value */
+  int16_t               data[3];    /* XL, GY, TEMP (data[0]) */
+  uint8_t               raw[6];     /* sensor hub slave / step counter */
+} lsm6dso32_fifo_record_t;
+
+typedef struct
+{
+  uint32_t  timestamp;      /* last decoded TIMESTAMP_TAG value */
+  uint8_t   ts_valid;       /* a TIMESTAMP_TAG word has been decoded */
+  uint32_t  words;          /* decoded FIFO words */
+  uint32_t  slave[4];       /* SENSORHUB_SLAVEx_TAG words */
+  uint32_t  nack[4];        /* SENSORHUB_NACK_TAG words per slave */
+} lsm6dso32_fifo_stream_t;
+
+#ifndef LSM6DSO32_FIFO_BURST_WORDS
+#define LSM6DSO32_FIFO_BURST_WORDS  8U  /* FIFO words per burst read */
+#endif /* LSM6DSO32_FIFO_BURST_WORDS */
+
+void lsm6dso32_fifo_stream_init(lsm6dso32_fifo_stream_t *stream);
+void lsm6dso32_fifo_record_decode(lsm6dso32_fifo_stream_t *stream,
+                                  const uint8_t *word,
+                                  lsm6dso32_fifo_record_t *rec);
+void lsm6dso32_fifo_words_unpack(const uint8_t *buff, uint16_t num,
+                                 uint8_t *tag, int16_t *data);
+int32_t lsm6dso32_fifo_stream_read(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_fifo_stream_t *stream,
+                                   lsm6dso32_fifo_record_t *rec,
+                                   uint16_t len, uint16_t *num);
+
+typedef struct
+{
+  float_t   t0;          /* reference temperature [degC] */
+  float_t   bias[3];     /* gyro bias at t0 [LSB] */
+  float_t   bias_tc[3];  /* gyro bias drift [LSB/degC] */
+  float_t   sens_tc[3];  /* gyro sensitivity drift [1/degC] */
+} lsm6dso32_gy_tcomp_coef_t;
+
+typedef struct
+{
+  lsm6dso32_gy_tcomp_coef_t  coef;
+  float_t                    temp;      /* last TEMPERATURE_TAG [degC] */
+  uint16_t                   since;     /* records since last temperature,
+                                           saturated at 0xFFFF */
+  uint8_t                    temp_valid;
+} lsm6dso32_gy_tcomp_t;
+void lsm6dso32_gy_tcomp_init(lsm6dso32_gy_tcomp_t *comp,
+                             const lsm6dso32_gy_tcomp_coef_t *coef);
+void lsm6dso32_gy_tcomp_apply(lsm6dso32_gy_tcomp_t *comp,
+                              lsm6dso32_fifo_record_t *rec, uint16_t num);
+
+typedef struct
+{
+  uint32_t  n;
+  double_t  st;          /* sum of (T - t0) */
+  double_t  stt;         /* sum of (T - t0)^2 */
+  double_t  sy[3];       /* sum of gyro output */
+  double_t  sty[3];      /* sum of (T - t0) * gyro output */
+  float_t   t0;
+} lsm6dso32_gy_tcomp_fit_t;
+void lsm6dso32_gy_tcomp_fit_init(lsm6dso32_gy_tcomp_fit_t *fit, float_t t0);
+void lsm6dso32_gy_tcomp_fit_add(lsm6dso32_gy_tcomp_fit_t *fit,
+                                float_t temp, const int16_t *gy);
+int32_t lsm6dso32_gy_tcomp_fit_solve(const lsm6dso32_gy_tcomp_fit_t *fit,
+                                     lsm6dso32_gy_tcomp_coef_t *coef);
+
+#define LSM6DSO32_RING_LEN  256U  /* records, must be a power of 2 */
+#ifndef LSM6DSO32_RING_FIFO_BATCH
+#define LSM6DSO32_RING_FIFO_BATCH  16U  /* slots reserved per FIFO read */
+#endif /* LSM6DSO32_RING_FIFO_BATCH */
+
+typedef struct
+{
+  volatile uint32_t        reserved;   /* records being written */
+  volatile uint32_t        head;       /* records published */
+  lsm6dso32_fifo_record_t  rec[LSM6DSO32_RING_LEN];
+} lsm6dso32_ring_t;
+void lsm6dso32_ring_init(lsm6dso32_ring_t *ring);
+void lsm6dso32_ring_publish(lsm6dso32_ring_t *ring,
+                            const lsm6dso32_fifo_record_t *rec,
+                            uint16_t num);
+int32_t lsm6dso32_ring_publish_fifo(const stmdev_ctx_t *ctx,
+                                    lsm6dso32_fifo_stream_t *stream,
+                                    lsm6dso32_ring_t *ring);
+uint16_t lsm6dso32_ring_read(const lsm6dso32_ring_t *ring, uint32_t *cursor,
+                             lsm6dso32_fifo_record_t *rec, uint16_t len,
+                             uint32_t *lost);
+
+#if LSM6DSO32_FEATURE_DEN
 typedef enum
 {
   LSM6DSO32_DEN_DISABLE    = 0,
@@ -3492,6 +3851,34 @@ int32_t lsm6dso32_den_mark_axis_z_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t lsm6dso32_den_mark_axis_z_get(const stmdev_ctx_t *ctx,
                                       uint8_t *val);
 
+typedef enum
+{
+  LSM6DSO32_DEN_LSB_KEEP   = 0,  /* leave DEN stamp in data LSB */
+  LSM6DSO32_DEN_LSB_CLEAR  = 1,  /* force stamped LSB to 0 */
+} lsm6dso32_den_lsb_t;
+
+typedef struct
+{
+  uint8_t               axis;     /* stamped axes: bit0 X, bit1 Y, bit2 Z */
+  lsm6dso32_den_xl_g_t  xl_g;     /* stamped sensor */
+  lsm6dso32_den_lsb_t   policy;
+  uint8_t               level;    /* last decoded DEN level */
+} lsm6dso32_den_decoder_t;
+
+typedef struct
+{
+  uint32_t  timestamp;  /* timestamp of the first sample at new level */
+  uint8_t   level;      /* 1: DEN asserted, 0: DEN released */
+} lsm6dso32_den_edge_t;
+int32_t lsm6dso32_den_decoder_init(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_den_decoder_t *dec,
+                                   lsm6dso32_den_lsb_t policy);
+uint8_t lsm6dso32_den_decode(lsm6dso32_den_decoder_t *dec,
+                             lsm6dso32_fifo_record_t *rec,
+                             lsm6dso32_den_edge_t *edge);
+#endif /* LSM6DSO32_FEATURE_DEN */
+
+#if LSM6DSO32_FEATURE_PEDO
 typedef enum
 {
   LSM6DSO32_PEDO_DISABLE              = 0x00,
@@ -3539,7 +3926,9 @@ int32_t lsm6dso32_tilt_sens_get(const stmdev_ctx_t *ctx, uint8_t *val);
 
 int32_t lsm6dso32_tilt_flag_data_ready_get(const stmdev_ctx_t *ctx,
                                            uint8_t *val);
+#endif /* LSM6DSO32_FEATURE_PEDO */
 
+#if LSM6DSO32_FEATURE_MAG
 int32_t lsm6dso32_mag_sensitivity_set(const stmdev_ctx_t *ctx,
                                       uint16_t val);
 int32_t lsm6dso32_mag_sensitivity_get(const stmdev_ctx_t *ctx,
@@ -3592,7 +3981,9 @@ int32_t lsm6dso32_mag_x_orient_set(const stmdev_ctx_t *ctx,
                                    lsm6dso32_mag_x_axis_t val);
 int32_t lsm6dso32_mag_x_orient_get(const stmdev_ctx_t *ctx,
                                    lsm6dso32_mag_x_axis_t *val);
+#endif /* LSM6DSO32_FEATURE_MAG */
 
+#if LSM6DSO32_FEATURE_FSM
 int32_t lsm6dso32_long_cnt_flag_data_ready_get(const stmdev_ctx_t *ctx,
                                                uint8_t *val);
 
@@ -3645,6 +4036,41 @@ typedef struct
 int32_t lsm6dso32_fsm_out_get(const stmdev_ctx_t *ctx,
                               lsm6dso32_fsm_out_t *val);
 
+typedef struct
+{
+  lsm6dso32_emb_func_status_t  emb_func_status;
+  lsm6dso32_fsm_status_a_t     fsm_status_a;
+  lsm6dso32_fsm_status_b_t     fsm_status_b;
+  uint16_t                     long_counter;
+  lsm6dso32_fsm_out_t          fsm_out;
+} lsm6dso32_fsm_snapshot_t;
+int32_t lsm6dso32_fsm_snapshot_get(const stmdev_ctx_t *ctx,
+                                   lsm6dso32_fsm_snapshot_t *val);
+
+#define LSM6DSO32_FSM_LOG_LEN          16U  /* must be a power of 2 */
+
+typedef struct
+{
+  uint32_t             timestamp;     /* device timestamp (LSB 25 us) */
+  uint16_t             status;        /* bit n -> FSM n+1 */
+  uint16_t             long_counter;
+  lsm6dso32_fsm_out_t  fsm_out;
+} lsm6dso32_fsm_event_t;
+
+typedef struct
+{
+  lsm6dso32_fsm_event_t  event[LSM6DSO32_FSM_LOG_LEN];
+  volatile uint16_t      head;        /* written by capture only */
+  volatile uint16_t      tail;        /* written by pop only */
+  uint32_t               count[16];   /* events per FSM */
+  uint32_t               dropped;     /* events lost on full log */
+} lsm6dso32_fsm_log_t;
+void lsm6dso32_fsm_log_init(lsm6dso32_fsm_log_t *log);
+int32_t lsm6dso32_fsm_log_capture(const stmdev_ctx_t *ctx,
+                                  lsm6dso32_fsm_log_t *log);
+uint8_t lsm6dso32_fsm_log_pop(lsm6dso32_fsm_log_t *log,
+                              lsm6dso32_fsm_event_t *val);
+
 typedef enum
 {
   LSM6DSO32_ODR_FSM_12Hz5 = 0,
@@ -3674,7 +4100,9 @@ int32_t lsm6dso32_fsm_start_address_set(const stmdev_ctx_t *ctx,
                                         uint16_t val);
 int32_t lsm6dso32_fsm_start_address_get(const stmdev_ctx_t *ctx,
                                         uint16_t *val);
+#endif /* LSM6DSO32_FEATURE_FSM */
 
+#if LSM6DSO32_FEATURE_SH
 typedef struct
 {
   lsm6dso32_sensor_hub_1_t   sh_byte_1;
@@ -3790,6 +4218,253 @@ int32_t lsm6dso32_sh_slv3_cfg_read(const stmdev_ctx_t *ctx,
 int32_t lsm6dso32_sh_status_get(const stmdev_ctx_t *ctx,
                                 lsm6dso32_status_master_t *val);
 
+typedef enum
+{
+  LSM6DSO32_SH_XFER_PENDING   = 0,
+  LSM6DSO32_SH_XFER_DONE      = 1,
+  LSM6DSO32_SH_XFER_NACK      = 2,
+} lsm6dso32_sh_xfer_status_t;
+
+typedef struct
+{
+  uint8_t   slv_add;     /* 7 bit i2c device address */
+  uint8_t   slv_subadd;  /* first register of the external device */
+  uint8_t   *data;       /* data to write / buffer for data read */
+  uint8_t   len;         /* num of bytes (read: 1 to 7) */
+  uint8_t   rd;          /* 0: write transaction, 1: read transaction */
+  lsm6dso32_sh_xfer_status_t status;
+} lsm6dso32_sh_xfer_t;
+
+typedef enum
+{
+  LSM6DSO32_SH_SEQ_IDLE         = 0,
+  LSM6DSO32_SH_SEQ_WAIT_TRIGGER = 1,
+  LSM6DSO32_SH_SEQ_WAIT_ENDOP   = 2,
+} lsm6dso32_sh_seq_state_t;
+
+typedef struct
+{
+  lsm6dso32_sh_xfer_t      *xfer;
+  uint8_t                  num;
+  uint8_t                  idx;    /* transaction in progress */
+  uint8_t                  ofs;    /* byte in progress (write only) */
+  uint8_t                  ext_trig;  /* MASTER_CONFIG.START_CONFIG */
+  int16_t                  xl_data[3];  /* sample read to clear XLDA */
+  uint8_t                  xl_drdy;     /* xl_data read by the last step */
+  lsm6dso32_sh_seq_state_t state;
+} lsm6dso32_sh_seq_t;
+int32_t lsm6dso32_sh_seq_init(lsm6dso32_sh_seq_t *seq,
+                              lsm6dso32_sh_xfer_t *xfer, uint8_t num);
+int32_t lsm6dso32_sh_seq_step(const stmdev_ctx_t *ctx,
+                              lsm6dso32_sh_seq_t *seq, uint8_t *done);
+int32_t lsm6dso32_sh_seq_run(const stmdev_ctx_t *ctx,
+                             lsm6dso32_sh_seq_t *seq, uint32_t timeout_ms);
+
+typedef struct
+{
+  const stmdev_ctx_t        *aux;   /* host bus routed to the aux I2C */
+  lsm6dso32_master_config_t saved;  /* MASTER_CONFIG before the session */
+  uint8_t                   active;
+} lsm6dso32_sh_pass_through_t;
+int32_t lsm6dso32_sh_pass_through_begin(const stmdev_ctx_t *ctx,
+                                        lsm6dso32_sh_pass_through_t *pt,
+                                        const stmdev_ctx_t *aux);
+int32_t lsm6dso32_sh_pass_through_end(const stmdev_ctx_t *ctx,
+                                      lsm6dso32_sh_pass_through_t *pt);
+
+#define LSM6DSO32_SH_PLAN_MAX_SENSORS  8U
+#define LSM6DSO32_SH_WINDOW_LEN        18U
+#define LSM6DSO32_SH_SLOT_MAX_LEN      7U
+#define LSM6DSO32_SH_MERGE_GAP         2U  /* < slot overhead on aux bus */
+
+typedef struct
+{
+  /* input */
+  uint8_t   slv_add;     /* 7 bit i2c device address */
+  uint8_t   slv_subadd;  /* first register of the span */
+  uint8_t   len;         /* span length in bytes */
+  uint16_t  odr_hz;      /* requested output rate */
+  uint8_t   batch;       /* store the slot in FIFO */
+  /* output */
+  uint8_t   slot;        /* assigned slave (0 to 3) */
+  uint8_t   ofs;         /* first byte in SENSOR_HUB_1..18 window */
+} lsm6dso32_sh_sensor_t;
+
+typedef struct
+{
+  lsm6dso32_sh_cfg_read_t   slv[4];
+  uint8_t                   batch[4];
+  uint8_t                   ofs[4];   /* window offset of each slot */
+  uint8_t                   num;      /* number of slots used */
+  uint8_t                   bytes;    /* window bytes used */
+  lsm6dso32_aux_sens_on_t   aux_sens_on;
+  lsm6dso32_shub_odr_t      odr;
+} lsm6dso32_sh_plan_t;
+int32_t lsm6dso32_sh_plan(lsm6dso32_sh_sensor_t *sensor, uint8_t num,
+                          lsm6dso32_sh_plan_t *plan);
+int32_t lsm6dso32_sh_plan_apply(const stmdev_ctx_t *ctx,
+                                const lsm6dso32_sh_plan_t *plan);
+#endif /* LSM6DSO32_FEATURE_SH */
+
+#if LSM6DSO32_FEATURE_ANALYTICS
+#define LSM6DSO32_QMON_SAT_LSB    32760  /* |raw| >= : saturated */
+#define LSM6DSO32_QMON_STUCK_RUN  64U    /* identical samples : stuck
+                                            (default of stuck_len) */
+
+typedef struct
+{
+  uint32_t  samples;
+  uint32_t  saturated[3];
+  uint32_t  spikes[3];
+  uint16_t  stuck_run[3];  /* current run of identical samples */
+  uint8_t   stuck;         /* bit n set: axis n stuck */
+  float_t   mean[3];       /* [mg] or [mdps] */
+  float_t   std[3];        /* [mg] or [mdps] */
+} lsm6dso32_health_t;
+
+typedef struct
+{
+  float_t             sens;       /* [mg/LSB] or [mdps/LSB] */
+  int32_t             spike_lsb;  /* sample to sample step : spike */
+  uint16_t            stuck_len;  /* identical samples : stuck,
+                                     0 : disabled */
+  double_t            mean[3];    /* [LSB] */
+  double_t            m2[3];      /* sum of squared deviations [LSB^2] */
+  int16_t             last[3];
+  lsm6dso32_health_t  health;
+} lsm6dso32_qmon_t;
+void lsm6dso32_qmon_xl_init(lsm6dso32_qmon_t *qm, lsm6dso32_fs_xl_t fs,
+                            float_t spike_mg);
+void lsm6dso32_qmon_gy_init(lsm6dso32_qmon_t *qm, lsm6dso32_fs_g_t fs,
+                            float_t spike_mdps);
+void lsm6dso32_qmon_update(lsm6dso32_qmon_t *qm, const int16_t *data,
+                           uint16_t num);
+
+#define LSM6DSO32_ADEV_TAUS  24U  /* octave spaced cluster sizes */
+
+typedef struct
+{
+  double_t  *sum;      /* caller buffer, 3 * len cumulative sums */
+  uint32_t  len;       /* cumulative sums kept per axis */
+  uint32_t  n;         /* samples pushed */
+  double_t  tau0;      /* sample period [s] */
+  double_t  acc[3];    /* running cumulative sum */
+  uint32_t  m[LSM6DSO32_ADEV_TAUS];
+  uint8_t   num_tau;
+  double_t  sq[LSM6DSO32_ADEV_TAUS][3];  /* sum of squared differences */
+  uint32_t  cnt[LSM6DSO32_ADEV_TAUS];
+} lsm6dso32_adev_t;
+
+typedef struct
+{
+  float_t   tau[LSM6DSO32_ADEV_TAUS];        /* [s] */
+  float_t   adev[LSM6DSO32_ADEV_TAUS][3];    /* [input unit] */
+  uint8_t   num_tau;
+  float_t   arw[3];               /* sigma at tau = 1 s [unit * s^0.5] */
+  float_t   bias_instability[3];  /* min sigma / 0.664 [unit] */
+  float_t   rrw[3];               /* sigma * sqrt(3 / tau) at max tau */
+} lsm6dso32_adev_result_t;
+int32_t lsm6dso32_adev_init(lsm6dso32_adev_t *av, double_t *buff,
+                            uint32_t len, float_t odr_hz);
+void lsm6dso32_adev_push(lsm6dso32_adev_t *av, const int16_t *data,
+                         uint16_t num, float_t sens);
+int32_t lsm6dso32_adev_get(const lsm6dso32_adev_t *av,
+                           lsm6dso32_adev_result_t *val);
+
+typedef struct
+{
+  lsm6dso32_ctrl1_xl_t     ctrl1_xl;
+  lsm6dso32_tap_cfg0_t     tap_cfg0;
+  lsm6dso32_tap_cfg1_t     tap_cfg1;
+  lsm6dso32_tap_cfg2_t     tap_cfg2;
+  lsm6dso32_tap_ths_6d_t   tap_ths_6d;
+  lsm6dso32_int_dur2_t     int_dur2;
+  lsm6dso32_wake_up_ths_t  wake_up_ths;
+  lsm6dso32_wake_up_dur_t  wake_up_dur;
+  lsm6dso32_free_fall_t    free_fall;
+} lsm6dso32_det_cfg_t;
+int32_t lsm6dso32_det_cfg_get(const stmdev_ctx_t *ctx,
+                              lsm6dso32_det_cfg_t *val);
+
+typedef struct
+{
+  lsm6dso32_all_int_src_t  all_int_src;
+  lsm6dso32_wake_up_src_t  wake_up_src;
+  lsm6dso32_tap_src_t      tap_src;
+  lsm6dso32_d6d_src_t      d6d_src;
+} lsm6dso32_det_src_t;
+
+typedef struct
+{
+  lsm6dso32_det_cfg_t  cfg;
+  lsm6dso32_det_src_t  latch;        /* sources accumulated with LIR */
+  /* thresholds [LSB] and windows [ODR cycles] from cfg */
+  int32_t   wu_ths;
+  int32_t   tap_ths[3];
+  int32_t   ff_ths;
+  int32_t   d6d_ths;
+  uint32_t  sleep_len;
+  uint16_t  shock_len;
+  uint16_t  quiet_len;
+  uint16_t  latency_len;
+  uint8_t   ff_dur;
+  /* filter and detector state (slope_fds HP is approximated) */
+  int32_t   lp[3];
+  int16_t   prev[3];
+  uint8_t   started;
+  uint32_t  sleep_cnt;
+  uint16_t  shock;
+  uint16_t  quiet;
+  uint16_t  latency;
+  uint8_t   wu_cnt;
+  uint8_t   ff_cnt;
+  uint8_t   sleep_state;
+  uint8_t   tap_over;
+  uint8_t   tap_src;      /* axis / sign of the tap in progress */
+  uint8_t   d6d_pos;
+} lsm6dso32_det_model_t;
+void lsm6dso32_det_model_init(lsm6dso32_det_model_t *model,
+                              const lsm6dso32_det_cfg_t *cfg);
+uint32_t lsm6dso32_det_model_run(lsm6dso32_det_model_t *model,
+                                 const int16_t *data, uint32_t num,
+                                 lsm6dso32_det_src_t *src);
+void lsm6dso32_det_model_ack(lsm6dso32_det_model_t *model);
+
+typedef enum
+{
+  LSM6DSO32_TUNE_WAKE_UP     = 0,
+  LSM6DSO32_TUNE_SINGLE_TAP  = 1,
+  LSM6DSO32_TUNE_FREE_FALL   = 2,
+} lsm6dso32_tune_det_t;
+
+typedef struct
+{
+  const int16_t   *data;       /* accelerometer X, Y, Z triplets */
+  uint32_t        num;         /* number of triplets */
+  const uint32_t  *event;      /* labeled event sample indexes, sorted */
+  uint16_t        num_event;
+} lsm6dso32_tune_capture_t;
+
+typedef struct
+{
+  uint8_t   ths;        /* wk_ths / tap_ths_x, y, z / ff_ths */
+  uint8_t   dur;        /* wake_dur / shock / ff_dur */
+  uint8_t   quiet;      /* quiet (single tap only) */
+  uint32_t  labeled;
+  uint32_t  detected;
+  uint32_t  false_evt;
+} lsm6dso32_tune_t;
+int32_t lsm6dso32_tune_run(lsm6dso32_tune_det_t det, lsm6dso32_fs_xl_t fs,
+                           const lsm6dso32_tune_capture_t *cap,
+                           uint8_t num_cap, uint16_t window,
+                           float_t target_rate, lsm6dso32_tune_t *val);
+#if LSM6DSO32_FEATURE_TAP
+int32_t lsm6dso32_tune_apply(const stmdev_ctx_t *ctx,
+                             lsm6dso32_tune_det_t det,
+                             const lsm6dso32_tune_t *val);
+#endif /* LSM6DSO32_FEATURE_TAP */
+#endif /* LSM6DSO32_FEATURE_ANALYTICS */
+
 /**
   * @}
   *
@@ -0,0 +1,71 @@
+#!/bin/sh
+#
+# Code size of the lsm6dso32 feature switches: text size of the full
+# build and saving of each LSM6DSO32_FEATURE_<name>=0 build, then a build
+# of every switch combination (2^7 builds, warnings as errors).
+#
+# usage: tools/section_size.sh [compiler [flags...]]
+#   tools/section_size.sh
+#   tools/section_size.sh arm-none-eabi-gcc -Os -mcpu=cortex-m4 -mthumb
+#
+# SIZE selects the size tool (default: <compiler prefix>size).
+#
+
+set -e
+
+dir=$(cd "$(dirname "$0")/.." && pwd)
+cc=${1:-gcc}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] || set -- -Os
+size=${SIZE:-$(echo "$cc" | sed 's/[^-]*$//')size}
+features="SH FSM PEDO MAG TAP DEN ANALYTICS"
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+# text size of a build with the given -D options
+text()
+{
+  "$cc" "$@" -c "$dir/lsm6dso32_reg.c" -o "$tmp/lsm6dso32_reg.o" || return 1
+  "$size" "$tmp/lsm6dso32_reg.o" | awk 'NR == 2 { print $1 }'
+}
+
+all=$(text "$@")
+fail=0
+printf '%-32s %8s %8s\n' 'build' 'text' 'saved'
+printf '%-32s %8d %8s\n' 'all features' "$all" '-'
+
+for f in $features; do
+  if t=$(text "$@" -DLSM6DSO32_FEATURE_$f=0); then
+    printf '%-32s %8d %8d\n' "LSM6DSO32_FEATURE_$f=0" "$t" $((all - t))
+  else
+    printf '%-32s %8s\n' "LSM6DSO32_FEATURE_$f=0" 'failed'
+    fail=1
+  fi
+done
+
+# every combination: bit n of the mask turns feature n off
+n=$(echo $features | wc -w)
+mask=0
+
+while [ $mask -lt $((1 << n)) ]; do
+  defs=""
+  i=0
+
+  for f in $features; do
+    [ $(((mask >> i) & 1)) -eq 1 ] && defs="$defs -DLSM6DSO32_FEATURE_$f=0"
+    i=$((i + 1))
+  done
+
+  if ! "$cc" "$@" -Wall -Wextra -Werror $defs -fsyntax-only \
+       "$dir/lsm6dso32_reg.c" 2> "$tmp/combo.log"; then
+    echo "section_size: build failed:$defs" >&2
+    cat "$tmp/combo.log" >&2
+    fail=1
+  fi
+
+  mask=$((mask + 1))
+done
+
+echo "combinations: $((1 << n)) checked"
+exit $fail
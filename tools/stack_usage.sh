@@ -0,0 +1,85 @@
+#!/bin/sh
+#
+# Stack usage table of the public lsm6dso32 functions, as reported by GCC
+# -fcallgraph-info=su: own frame and worst case call-chain depth (bytes),
+# deepest first.
+#
+# usage: tools/stack_usage.sh [compiler [flags...]]
+#   tools/stack_usage.sh
+#   tools/stack_usage.sh arm-none-eabi-gcc -Os -mcpu=cortex-m4 -mthumb
+#
+# The depth is the largest sum of frames along the calls made inside the
+# driver. The platform read / write / delay callbacks (indirect calls)
+# and library functions are not included: add their own usage.
+#
+# With STACK_LIMIT=<bytes> in the environment the script fails when the
+# depth of a function is above the limit.
+#
+
+set -e
+
+dir=$(cd "$(dirname "$0")/.." && pwd)
+cc=${1:-gcc}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] || set -- -O2
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+(cd "$tmp" && "$cc" "$@" -fcallgraph-info=su -c "$dir/lsm6dso32_reg.c" \
+  -o lsm6dso32_reg.o)
+
+# public API: every lsm6dso32_ function declared in the header
+grep -o 'lsm6dso32_[a-z0-9_]*(' "$dir/lsm6dso32_reg.h" | tr -d '(' |
+  sort -u > "$tmp/api"
+
+# call graph: "node <name> <bytes> <type>" and "edge <caller> <callee>"
+sed -n \
+  -e 's/^node: { title: "\([^"]*\)" label: "[^"]*\\n\([0-9]*\) bytes (\([^)]*\))".*/node \1 \2 \3/p' \
+  -e 's/^edge: { sourcename: "\([^"]*\)" targetname: "\([^"]*\)".*/edge \1 \2/p' \
+  "$tmp/lsm6dso32_reg.ci" | sed 's/[^ ]*:\(lsm6dso32_[a-z0-9_]*\)/\1/g' \
+  > "$tmp/graph"
+
+awk '
+  function depth(f,    i, d, m, c)
+  {
+    if (f in memo) return memo[f]
+    if (busy[f]) { rec[f] = 1; return 0 }
+    busy[f] = 1
+    m = 0
+    for (i = 1; i <= ncall[f]; i++) {
+      c = call[f, i]
+      d = depth(c)
+      if (rec[c]) rec[f] = 1
+      if (dyn[c]) dyn[f] = 1
+      if (d > m) m = d
+    }
+    busy[f] = 0
+    memo[f] = frame[f] + m
+    return memo[f]
+  }
+  FILENAME == ARGV[1] { api[$1] = 1; next }
+  $1 == "node" { frame[$2] = $3; dyn[$2] = ($4 != "static") }
+  $1 == "edge" && !(($2, $3) in seen) {
+    seen[$2, $3] = 1; call[$2, ++ncall[$2]] = $3
+  }
+  END {
+    for (f in api) {
+      if (!(f in frame)) continue
+      d = depth(f)
+      printf "%s\t%d\t%d\t%s%s\n", f, frame[f], d,
+             dyn[f] ? "dynamic" : "static", rec[f] ? ",recursive" : ""
+    }
+  }' "$tmp/api" "$tmp/graph" | sort -t"$(printf '\t')" -k3,3nr -k1,1 \
+  > "$tmp/table"
+
+printf '%-48s %6s %6s  %s\n' 'function' 'frame' 'depth' 'type'
+awk -F'\t' '{ printf "%-48s %6d %6d  %s\n", $1, $2, $3, $4 }' "$tmp/table"
+
+if [ -n "$STACK_LIMIT" ]; then
+  awk -F'\t' -v limit="$STACK_LIMIT" '$3 > limit || $4 ~ /recursive/ {
+      print "stack_usage: " $1 " depth " $3 " > " limit > "/dev/stderr"
+      bad = 1
+    }
+    END { exit bad }' "$tmp/table"
+fi
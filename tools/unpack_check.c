@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file    unpack_check.c
+  * @author  Sensors Software Solution Team
+  * @brief   Host check of lsm6dso32_fifo_words_unpack against a scalar
+  *          reference (see unpack_check.sh)
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lsm6dso32_reg.h"
+
+#define CHECK_WORDS   64U    /* longest burst checked */
+#define CHECK_ROUNDS  1000U  /* random bursts per length */
+#define CHECK_GUARD   8U     /* output entries that must stay untouched */
+
+#if (DRV_BYTE_ORDER == DRV_LITTLE_ENDIAN) && defined(__SSSE3__)
+#define CHECK_PATH  "SSSE3"
+#elif (DRV_BYTE_ORDER == DRV_LITTLE_ENDIAN) && defined(__aarch64__) && \
+      defined(__ARM_NEON)
+#define CHECK_PATH  "NEON"
+#else
+#define CHECK_PATH  "scalar"
+#endif /* SIMD FIFO unpack */
+
+/* byte by byte reference: TAG_SENSOR and little-endian X, Y, Z */
+static void ref_unpack(const uint8_t *buff, uint16_t num,
+                       uint8_t *tag, int16_t *data)
+{
+  uint16_t i;
+  uint8_t k;
+
+  for (i = 0U; i < num; i++)
+  {
+    tag[i] = buff[7U * i] >> 3;
+
+    for (k = 0U; k < 3U; k++)
+    {
+      data[(3U * i) + k] = (int16_t)((uint16_t)buff[(7U * i) + (2U * k) + 1U] |
+                                     ((uint16_t)buff[(7U * i) + (2U * k) + 2U]
+                                      << 8));
+    }
+  }
+}
+
+int main(void)
+{
+  uint8_t tag[CHECK_WORDS + CHECK_GUARD];
+  uint8_t tag_ref[CHECK_WORDS + CHECK_GUARD];
+  int16_t data[3U * (CHECK_WORDS + CHECK_GUARD)];
+  int16_t data_ref[3U * (CHECK_WORDS + CHECK_GUARD)];
+  uint8_t *buff;
+  uint32_t errors = 0U;
+  uint32_t round;
+  uint16_t num;
+  uint16_t i;
+
+  srand(1U);
+
+  for (num = 0U; num <= CHECK_WORDS; num++)
+  {
+    /* exact size: an over-read is caught by ASan / valgrind */
+    buff = malloc((num > 0U) ? (7U * num) : 1U);
+
+    if (buff == NULL)
+    {
+      return 2;
+    }
+
+    for (round = 0U; round < CHECK_ROUNDS; round++)
+    {
+      for (i = 0U; i < (7U * num); i++)
+      {
+        buff[i] = (uint8_t)rand();
+      }
+
+      for (i = 0U; i < (CHECK_WORDS + CHECK_GUARD); i++)
+      {
+        tag[i] = 0xA5U;
+        tag_ref[i] = 0xA5U;
+        data[3U * i] = 0x5A5A;
+        data[(3U * i) + 1U] = 0x5A5A;
+        data[(3U * i) + 2U] = 0x5A5A;
+        data_ref[3U * i] = 0x5A5A;
+        data_ref[(3U * i) + 1U] = 0x5A5A;
+        data_ref[(3U * i) + 2U] = 0x5A5A;
+      }
+
+      lsm6dso32_fifo_words_unpack(buff, num, tag, data);
+      ref_unpack(buff, num, tag_ref, data_ref);
+
+      /* words 0..num-1 must match, the guard must be left untouched */
+      for (i = 0U; i < (CHECK_WORDS + CHECK_GUARD); i++)
+      {
+        if ((tag[i] != tag_ref[i]) ||
+            (data[3U * i] != data_ref[3U * i]) ||
+            (data[(3U * i) + 1U] != data_ref[(3U * i) + 1U]) ||
+            (data[(3U * i) + 2U] != data_ref[(3U * i) + 2U]))
+        {
+          if (errors < 10U)
+          {
+            printf("mismatch: num %u word %u\n", (unsigned)num,
+                   (unsigned)i);
+          }
+
+          errors++;
+        }
+      }
+    }
+
+    free(buff);
+  }
+
+  printf("unpack_check (%s): %u bursts, %lu errors\n", CHECK_PATH,
+         (unsigned)((CHECK_WORDS + 1U) * CHECK_ROUNDS),
+         (unsigned long)errors);
+
+  return (errors == 0U) ? 0 : 1;
+}
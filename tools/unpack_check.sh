@@ -0,0 +1,28 @@
+#!/bin/sh
+#
+# Check lsm6dso32_fifo_words_unpack (SSSE3 / NEON / scalar path, as
+# selected by the compiler flags) against a byte by byte reference.
+#
+# usage: tools/unpack_check.sh [compiler [flags...]]
+#   tools/unpack_check.sh
+#   tools/unpack_check.sh gcc -O2 -mssse3 -fsanitize=address
+#   tools/unpack_check.sh aarch64-linux-gnu-gcc -O2 -static
+#
+# The check binary runs on the host: for a cross compiler set RUN to the
+# emulator (e.g. RUN=qemu-aarch64).
+#
+
+set -e
+
+dir=$(cd "$(dirname "$0")/.." && pwd)
+cc=${1:-gcc}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] || set -- -O2
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+"$cc" "$@" -I"$dir" "$dir/tools/unpack_check.c" "$dir/lsm6dso32_reg.c" \
+  -o "$tmp/unpack_check" -lm
+
+$RUN "$tmp/unpack_check"